@@ -0,0 +1,172 @@
+/*!
+ * \file bloom_filter.cpp
+ * Implementation of the cache-line-blocked Bloom filter.
+ * \date October 19th, 2026.
+ */
+
+#include "bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace sa {
+
+    const std::size_t blocked_bloom::block_bytes;
+    const std::size_t blocked_bloom::block_words;
+
+    namespace {
+
+        /// Mixes the bits of `key` (the 64-bit finalizer from MurmurHash3).
+        inline std::uint64_t mix( value_type key )
+        {
+            std::uint64_t h = static_cast<std::uint32_t>( key );
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /// Blocking wastes a little precision, so we pay for it with a few extra bits per key.
+        const double blocking_overhead{ 1.2 };
+    }
+
+    blocked_bloom::blocked_bloom( const value_type * first, const value_type * last, double fp_rate, std::size_t max_bytes )
+        : m_blocks{ nullptr }, m_n_blocks{ 0 }, m_n_keys{ static_cast<std::size_t>( last - first ) }, m_k{ 1 }
+    {
+        fp_rate = std::min( std::max( fp_rate, 1e-9 ), 0.5 );
+
+        // Optimal Bloom sizing: m/n = -log2(p) / ln(2) bits per key, k = (m/n) ln(2).
+        const double bits_per_key = blocking_overhead * -std::log2( fp_rate ) / std::log( 2.0 );
+        std::size_t bits = static_cast<std::size_t>( std::ceil( bits_per_key * static_cast<double>( m_n_keys ) ) );
+        m_n_blocks = std::max<std::size_t>( 1, ( bits + block_bytes * 8 - 1 ) / ( block_bytes * 8 ) );
+        if ( max_bytes != 0 ) {
+            m_n_blocks = std::max<std::size_t>( 1, std::min( m_n_blocks, max_bytes / block_bytes ) );
+        }
+
+        // Recompute k for the bits we actually got.
+        const double actual_bits_per_key = m_n_keys == 0 ? bits_per_key
+            : static_cast<double>( m_n_blocks * block_bytes * 8 ) / static_cast<double>( m_n_keys );
+        m_k = static_cast<unsigned>( std::lround( actual_bits_per_key * std::log( 2.0 ) ) );
+        m_k = std::min( std::max( m_k, 1u ), 16u );
+
+        allocate();
+
+        for ( ; first != last ; ++first ) {
+            std::uint64_t h = mix( *first );
+            std::uint64_t * block = m_blocks + ( ( ( h >> 32 ) * m_n_blocks ) >> 32 ) * block_words;
+            std::uint32_t h1 = static_cast<std::uint32_t>( h );
+            std::uint32_t h2 = ( h1 >> 16 ) | ( h1 << 16 ) | 1;
+            for ( unsigned i{0} ; i < m_k ; ++i ) {
+                std::uint32_t bit = ( h1 + i * h2 ) & ( block_bytes * 8 - 1 );
+                block[ bit / 64 ] |= std::uint64_t{1} << ( bit % 64 );
+            }
+        }
+    }
+
+    blocked_bloom::blocked_bloom( const blocked_bloom & other )
+        : m_blocks{ nullptr }, m_n_blocks{ other.m_n_blocks }, m_n_keys{ other.m_n_keys }, m_k{ other.m_k }
+    {
+        // `m_blocks` points into the storage, so the copy needs its own, aligned on its own.
+        allocate();
+        std::copy( other.m_blocks, other.m_blocks + m_n_blocks * block_words, m_blocks );
+    }
+
+    blocked_bloom::blocked_bloom( blocked_bloom && other )
+        : m_storage{ std::move( other.m_storage ) }, m_blocks{ other.m_blocks },
+          m_n_blocks{ other.m_n_blocks }, m_n_keys{ other.m_n_keys }, m_k{ other.m_k }
+    {
+        other.m_blocks = nullptr;
+        other.m_n_blocks = other.m_n_keys = 0;
+    }
+
+    blocked_bloom & blocked_bloom::operator=( blocked_bloom other )
+    {
+        // Swapping the vectors swaps their buffers, so each `m_blocks` still points into its own.
+        std::swap( m_storage, other.m_storage );
+        std::swap( m_blocks, other.m_blocks );
+        std::swap( m_n_blocks, other.m_n_blocks );
+        std::swap( m_n_keys, other.m_n_keys );
+        std::swap( m_k, other.m_k );
+        return *this;
+    }
+
+    void blocked_bloom::allocate( void )
+    {
+        m_storage.assign( m_n_blocks * block_words + block_words, 0 );
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>( m_storage.data() );
+        std::size_t offset = ( block_bytes - address % block_bytes ) % block_bytes;
+        m_blocks = m_storage.data() + offset / sizeof(std::uint64_t);
+    }
+
+    /*!
+     * Checks whether `value` may be among the keys the filter was built with.
+     * \param value The value we are looking for.
+     * \return `false` if `value` is certainly absent, `true` otherwise.
+     */
+    bool blocked_bloom::may_contain( value_type value ) const
+    {
+        std::uint64_t h = mix( value );
+        const std::uint64_t * block = m_blocks + ( ( ( h >> 32 ) * m_n_blocks ) >> 32 ) * block_words;
+        std::uint32_t h1 = static_cast<std::uint32_t>( h );
+        std::uint32_t h2 = ( h1 >> 16 ) | ( h1 << 16 ) | 1;
+
+        // Gather the probed bits into a mask per word, then test all of them together.
+        std::uint64_t masks[block_words] = {};
+        for ( unsigned i{0} ; i < m_k ; ++i ) {
+            std::uint32_t bit = ( h1 + i * h2 ) & ( block_bytes * 8 - 1 );
+            masks[ bit / 64 ] |= std::uint64_t{1} << ( bit % 64 );
+        }
+        std::uint64_t missing{0};
+        for ( std::size_t w{0} ; w < block_words ; ++w ) {
+            missing |= masks[w] & ~block[w];
+        }
+        return missing == 0;
+    }
+
+    double blocked_bloom::expected_fp_rate( void ) const
+    {
+        if ( m_n_keys == 0 ) {
+            return 0.0;
+        }
+        const double m = static_cast<double>( m_n_blocks * block_bytes * 8 );
+        const double k = static_cast<double>( m_k );
+        return std::pow( 1.0 - std::exp( -k * static_cast<double>( m_n_keys ) / m ), k );
+    }
+
+    /*!
+     * Performs a **binary search** for `value` in `[first;last)`, unless `filter` rules `value` out.
+     * Returns a pointer to the location of `value` in the range `[first,last]`, or `last` if no such element is found.
+     * \note The range **must** be sorted, and `filter` must have been built over it.
+     * \param filter A filter built over `[first;last)`.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * bsearch( const blocked_bloom & filter, value_type * first, value_type * last, value_type value )
+    {
+        if ( not filter.may_contain( value ) ) {
+            return last;
+        }
+        return bsearch( first, last, value );
+    }
+
+    /*!
+     * Performs a **linear search** for `value` in `[first;last)`, unless `filter` rules `value` out.
+     * Returns a pointer to the location of `value` in the range `[first,last]`, or `last` if no such element is found.
+     * \note `filter` must have been built over `[first;last)`.
+     * \param filter A filter built over `[first;last)`.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * lsearch( const blocked_bloom & filter, value_type * first, value_type * last, value_type value )
+    {
+        if ( not filter.may_contain( value ) ) {
+            return last;
+        }
+        return lsearch( first, last, value );
+    }
+}
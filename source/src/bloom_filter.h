@@ -0,0 +1,83 @@
+/*!
+ * \file bloom_filter.h
+ * A cache-line-blocked Bloom filter that lets the search functions reject absent keys early.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * Blocked Bloom filter over the keys of a range.
+     *
+     * Every key sets all of its bits inside a single 64-byte block (one cache line), so a query
+     * costs at most one cache miss. A negative answer is always right; a positive one is wrong
+     * with a probability close to the false-positive rate requested at construction.
+     *
+     * The filter only stores bits, not the range, so it may outlive it; it must be rebuilt if the
+     * range changes.
+     */
+    class blocked_bloom {
+        public:
+            /*!
+             * Builds the filter over `[first,last)`.
+             * \param first Pointer to the begining of the data range.
+             * \param last Pointer just past the last element of the data range.
+             * \param fp_rate Target false-positive rate, in `(0,1)`.
+             * \param max_bytes Memory budget; 0 means unlimited. If the budget is too small for
+             *        `fp_rate`, the filter uses the whole budget and the actual rate is higher.
+             */
+            blocked_bloom( const value_type * first, const value_type * last, double fp_rate=0.01, std::size_t max_bytes=0 );
+
+            /// Copies the bits into a buffer of its own, aligned afresh.
+            blocked_bloom( const blocked_bloom & other );
+            /// Takes over the buffer of `other`, which is left empty.
+            blocked_bloom( blocked_bloom && other );
+            /// Copy or move assignment.
+            blocked_bloom & operator=( blocked_bloom other );
+
+            /// Returns `false` if `value` is certainly absent, `true` if it may be present.
+            bool may_contain( value_type value ) const;
+
+            /// The false-positive rate expected for the keys the filter was built with.
+            double expected_fp_rate( void ) const;
+
+            /// Bytes used by the filter.
+            std::size_t memory_bytes( void ) const { return m_n_blocks * block_bytes; }
+
+            /// Number of bits set (probed) per key.
+            unsigned n_hashes( void ) const { return m_k; }
+
+        private:
+            /// Bytes in a block, i.e. a cache line.
+            static const std::size_t block_bytes = 64;
+            /// 64-bit words in a block.
+            static const std::size_t block_words = block_bytes / sizeof(std::uint64_t);
+
+            /// Allocates `m_n_blocks` zeroed blocks and points `m_blocks` at the first one.
+            void allocate( void );
+
+            std::vector<std::uint64_t> m_storage; //!< Backing storage, with room to align the blocks.
+            std::uint64_t * m_blocks;             //!< First block, aligned to a cache line.
+            std::size_t m_n_blocks;               //!< Number of blocks.
+            std::size_t m_n_keys;                 //!< Number of keys inserted.
+            unsigned m_k;                         //!< Bits set per key.
+    };
+
+    /// Binary search that consults `filter` first, skipping the search for keys it rejects.
+    value_type * bsearch( const blocked_bloom & filter, value_type * first, value_type * last, value_type value );
+
+    /// Linear search that consults `filter` first, skipping the scan for keys it rejects.
+    value_type * lsearch( const blocked_bloom & filter, value_type * first, value_type * last, value_type value );
+}
+
+#endif // BLOOM_FILTER_H
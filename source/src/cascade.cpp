@@ -0,0 +1,107 @@
+/*!
+ * \file cascade.cpp
+ * Implementation of the fractional cascading index.
+ *
+ * Augmented array `i` holds array `i` merged with the keys at odd positions 1, 3, 5, ... of
+ * augmented array `i+1`. If `p` is the lower bound of a key in augmented array `i` and `c`
+ * promoted keys come before `p`, then keys `1, 3, ..., 2c-1` of the next level are less than the
+ * key and key `2c+1` is not, so the lower bound there is `2c` or `2c+1`.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "cascade.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace sa {
+
+    /*!
+     * Builds the augmented arrays, from the last array up.
+     * \param arrays The sorted ranges `[first,last)`, in the order results are returned.
+     * \throw std::length_error if an augmented array would not be addressable with 32-bit counts.
+     */
+    cascade_index::cascade_index( const std::vector< std::pair<value_type *, value_type *> > & arrays )
+        : m_levels( arrays.size() )
+    {
+        for ( std::size_t i = arrays.size() ; i-- > 0 ; ) {
+            const value_type * a = arrays[i].first;
+            const value_type * a_last = arrays[i].second;
+            const std::vector<value_type> * below = i + 1 < arrays.size() ? &m_levels[i + 1].keys : nullptr;
+            const std::size_t n_below = below ? below->size() / 2 : 0;
+            const std::size_t n = static_cast<std::size_t>( a_last - a ) + n_below;
+            if ( n >= std::numeric_limits<std::uint32_t>::max() ) {
+                throw std::length_error( "cascade_index: arrays are too large" );
+            }
+
+            level_t & level = m_levels[i];
+            level.keys.reserve( n );
+            level.own.reserve( n + 1 );
+            level.down.reserve( n + 1 );
+
+            std::uint32_t own{0}, down{0};
+            std::size_t b{0};  // Next promoted key: ( *below )[ 2b + 1 ].
+            while ( a != a_last || b < n_below ) {
+                level.own.push_back( own );
+                level.down.push_back( down );
+                if ( b == n_below || ( a != a_last && *a <= ( *below )[ 2 * b + 1 ] ) ) {
+                    level.keys.push_back( *a++ );
+                    ++own;
+                }
+                else {
+                    level.keys.push_back( ( *below )[ 2 * b + 1 ] );
+                    ++b;
+                    ++down;
+                }
+            }
+            level.own.push_back( own );
+            level.down.push_back( down );
+        }
+    }
+
+    /*!
+     * Finds the lower bound of `value` in every array.
+     * \param value The value we are looking for.
+     * \param out Receives `n_arrays()` indices: the first element of each array that is _not less_ than `value`, or its size.
+     */
+    void cascade_index::lbound( value_type value, std::size_t * out ) const
+    {
+        if ( m_levels.empty() ) {
+            return;
+        }
+        // The only full search, in the first augmented array.
+        value_type* top = const_cast<value_type*>( m_levels[0].keys.data() );
+        std::size_t p = static_cast<std::size_t>( sa::lbound( top, top + m_levels[0].keys.size(), value ) - top );
+        for ( std::size_t i{0} ; i < m_levels.size() ; ++i ) {
+            const level_t & level = m_levels[i];
+            out[i] = level.own[p];
+            if ( i + 1 < m_levels.size() ) {
+                const std::vector<value_type> & next = m_levels[i + 1].keys;
+                std::size_t q = 2 * static_cast<std::size_t>( level.down[p] );
+                p = q + ( q < next.size() && next[q] < value ? 1 : 0 );
+            }
+        }
+    }
+
+    /*!
+     * Finds the lower bound of `value` in every array.
+     * \param value The value we are looking for.
+     * \return One index per array: the first element that is _not less_ than `value`, or the array's size.
+     */
+    std::vector<std::size_t> cascade_index::lbound( value_type value ) const
+    {
+        std::vector<std::size_t> positions( m_levels.size() );
+        lbound( value, positions.data() );
+        return positions;
+    }
+
+    std::size_t cascade_index::memory_bytes( void ) const
+    {
+        std::size_t bytes{0};
+        for ( const auto & level : m_levels ) {
+            bytes += level.keys.size() * sizeof(value_type) + ( level.own.size() + level.down.size() ) * sizeof(std::uint32_t);
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,63 @@
+/*!
+ * \file cascade.h
+ * Fractional cascading: one key searched across many sorted arrays.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef CASCADE_H
+#define CASCADE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * Lower bounds of a key in every one of a list of sorted arrays (e.g. one per shard or time
+     * bucket), at the cost of a single binary search plus O(1) work per array.
+     *
+     * The index keeps an augmented copy of every array: the augmented array `i` merges array `i`
+     * with every second key of augmented array `i+1`, and each of its positions records how many
+     * keys before it came from array `i` and how many were promoted from below. The key is binary
+     * searched once, in augmented array 0; from there, the lower bound in each original array is
+     * read off directly, and the position in the next augmented array is narrowed to two
+     * candidates, settled with a single comparison.
+     *
+     * The augmented copies take at most twice the total size of the arrays. The arrays are copied,
+     * so they need not outlive the index.
+     */
+    class cascade_index {
+        public:
+            /// Builds the index over the sorted ranges `[first,last)` in `arrays`.
+            explicit cascade_index( const std::vector< std::pair<value_type *, value_type *> > & arrays );
+
+            /// Lower bound of `value` in every array, as an index into that array.
+            std::vector<std::size_t> lbound( value_type value ) const;
+
+            /// Same as `lbound()`, storing the `n_arrays()` indices in `out`.
+            void lbound( value_type value, std::size_t * out ) const;
+
+            /// Number of arrays.
+            std::size_t n_arrays( void ) const { return m_levels.size(); }
+
+            /// Bytes used by the augmented arrays.
+            std::size_t memory_bytes( void ) const;
+
+        private:
+            /// An augmented array.
+            struct level_t {
+                std::vector<value_type> keys;     //!< The merged keys.
+                std::vector<std::uint32_t> own;   //!< Keys of the original array before each position (one extra at the end).
+                std::vector<std::uint32_t> down;  //!< Keys promoted from the next level before each position (one extra at the end).
+            };
+
+            std::vector<level_t> m_levels; //!< One per array, in the order given.
+    };
+}
+
+#endif // CASCADE_H
@@ -0,0 +1,165 @@
+/*!
+ * \file composite.cpp
+ * Implementation of the lexicographic multi-column search.
+ * \date October 19th, 2026.
+ */
+
+#include "composite.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sa {
+
+    /*!
+     * Builds the index.
+     * \param columns Pointers to the key columns, most significant first; each holds `n_rows` values.
+     * \param n_rows Number of rows.
+     * \throw std::invalid_argument if no column is given.
+     */
+    composite_index::composite_index( const std::vector<value_type *> & columns, std::size_t n_rows )
+        : m_columns{ columns }, m_n_rows{ n_rows }
+    {
+        if ( m_columns.empty() ) {
+            throw std::invalid_argument( "composite_index: at least one column is required" );
+        }
+    }
+
+    /*!
+     * Narrows the rows to those whose first `n` columns are equal to the first `n` components of `key`.
+     * The first column is searched by galloping from `hint`, which makes batches of nearby keys cheap;
+     * each following column is searched only within the rows left by the previous one.
+     * If the result is empty, its position is where such rows would be.
+     */
+    row_range composite_index::narrow( const value_type * key, std::size_t n, std::size_t hint ) const
+    {
+        row_range rows{ 0, m_n_rows };
+
+        for ( std::size_t c{0} ; c < n && rows.first < rows.last ; ++c ) {
+            value_type* column = m_columns[c];
+            value_type* lo;
+            value_type* hi;
+            if ( c == 0 ) {
+                lo = lbound_hint( column, column + m_n_rows, key[0], column + std::min( hint, m_n_rows ) );
+                hi = ubound_hint( lo, column + m_n_rows, key[0], lo );
+            }
+            else {
+                lo = sa::lbound( column + rows.first, column + rows.last, key[c] );
+                hi = sa::ubound( lo, column + rows.last, key[c] );
+            }
+            rows.first = static_cast<std::size_t>( lo - column );
+            rows.last = static_cast<std::size_t>( hi - column );
+        }
+
+        return rows;
+    }
+
+    /*!
+     * Returns the rows whose leading `key_len` columns are equal to `key`.
+     * \param key The key components, most significant first.
+     * \param key_len Number of components in `key`; at most `n_columns()`.
+     */
+    row_range composite_index::equal_range( const value_type * key, std::size_t key_len ) const
+    {
+        return narrow( key, std::min( key_len, m_columns.size() ), 0 );
+    }
+
+    /*!
+     * Returns the first row whose leading `key_len` columns are _not less_ than `key`, or `n_rows()` if there is no such row.
+     * \param key The key components, most significant first.
+     * \param key_len Number of components in `key`; at most `n_columns()`.
+     */
+    std::size_t composite_index::lbound( const value_type * key, std::size_t key_len ) const
+    {
+        // Rows matching all but the last component; the lower bound is inside them (or where they would be).
+        key_len = std::min( key_len, m_columns.size() );
+        if ( key_len == 0 ) {
+            return 0;
+        }
+        row_range rows = narrow( key, key_len - 1, 0 );
+        value_type* column = m_columns[key_len - 1];
+        return static_cast<std::size_t>( sa::lbound( column + rows.first, column + rows.last, key[key_len - 1] ) - column );
+    }
+
+    /*!
+     * Returns the first row whose leading `key_len` columns are _greater_ than `key`, or `n_rows()` if there is no such row.
+     * \param key The key components, most significant first.
+     * \param key_len Number of components in `key`; at most `n_columns()`.
+     */
+    std::size_t composite_index::ubound( const value_type * key, std::size_t key_len ) const
+    {
+        key_len = std::min( key_len, m_columns.size() );
+        if ( key_len == 0 ) {
+            return m_n_rows;
+        }
+        row_range rows = narrow( key, key_len - 1, 0 );
+        value_type* column = m_columns[key_len - 1];
+        return static_cast<std::size_t>( sa::ubound( column + rows.first, column + rows.last, key[key_len - 1] ) - column );
+    }
+
+    /*!
+     * Batch version of `equal_range()`. Consecutive queries with close first components reuse the
+     * previous position as a starting point, so sorted or clustered batches are cheaper.
+     * \param keys `n_queries` keys of `key_len` components each, stored one after the other.
+     * \param key_len Number of components per key; at most `n_columns()`.
+     * \param n_queries Number of keys.
+     * \param out Receives one row range per key.
+     */
+    void composite_index::equal_range( const value_type * keys, std::size_t key_len, std::size_t n_queries, row_range * out ) const
+    {
+        const std::size_t n = std::min( key_len, m_columns.size() );
+        std::size_t hint{0};
+        for ( std::size_t q{0} ; q < n_queries ; ++q ) {
+            out[q] = narrow( keys + q * key_len, n, hint );
+            hint = out[q].first;
+        }
+    }
+
+    /*!
+     * Batch version of `lbound()`.
+     * \param keys `n_queries` keys of `key_len` components each, stored one after the other.
+     * \param key_len Number of components per key; at most `n_columns()`.
+     * \param n_queries Number of keys.
+     * \param out Receives one row index per key.
+     */
+    void composite_index::lbound( const value_type * keys, std::size_t key_len, std::size_t n_queries, std::size_t * out ) const
+    {
+        const std::size_t n = std::min( key_len, m_columns.size() );
+        std::size_t hint{0};
+        for ( std::size_t q{0} ; q < n_queries ; ++q ) {
+            const value_type * key = keys + q * key_len;
+            if ( n == 0 ) {
+                out[q] = 0;
+                continue;
+            }
+            row_range rows = narrow( key, n - 1, hint );
+            value_type* column = m_columns[n - 1];
+            out[q] = static_cast<std::size_t>( sa::lbound( column + rows.first, column + rows.last, key[n - 1] ) - column );
+            hint = out[q];
+        }
+    }
+
+    /*!
+     * Batch version of `ubound()`.
+     * \param keys `n_queries` keys of `key_len` components each, stored one after the other.
+     * \param key_len Number of components per key; at most `n_columns()`.
+     * \param n_queries Number of keys.
+     * \param out Receives one row index per key.
+     */
+    void composite_index::ubound( const value_type * keys, std::size_t key_len, std::size_t n_queries, std::size_t * out ) const
+    {
+        const std::size_t n = std::min( key_len, m_columns.size() );
+        std::size_t hint{0};
+        for ( std::size_t q{0} ; q < n_queries ; ++q ) {
+            const value_type * key = keys + q * key_len;
+            if ( n == 0 ) {
+                out[q] = m_n_rows;
+                continue;
+            }
+            row_range rows = narrow( key, n - 1, hint );
+            value_type* column = m_columns[n - 1];
+            out[q] = static_cast<std::size_t>( sa::ubound( column + rows.first, column + rows.last, key[n - 1] ) - column );
+            hint = rows.first;
+        }
+    }
+}
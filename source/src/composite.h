@@ -0,0 +1,75 @@
+/*!
+ * \file composite.h
+ * Lexicographic search over multi-column keys stored as a struct of arrays.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef COMPOSITE_H
+#define COMPOSITE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /// A closed-open range of rows, `[first,last)`.
+    struct row_range {
+        std::size_t first; //!< First row in the range.
+        std::size_t last;  //!< Just past the last row in the range.
+    };
+
+    /*!
+     * Search over rows whose key is split across several columns, e.g. `(tenant_id, timestamp)`.
+     *
+     * Each column is a separate array with one entry per row (struct of arrays), and the rows
+     * **must** be sorted lexicographically by `(column 0, column 1, ...)`. A search narrows the
+     * rows with `sa::lbound`/`sa::ubound` on the first column, then searches only that sub-range
+     * of the next column, and so on, so keys never have to be packed into a single integer.
+     *
+     * A key may be a prefix: searching with fewer components than columns compares only the
+     * leading columns. Results are row indices.
+     *
+     * \note The columns are not owned; they must outlive the index.
+     */
+    class composite_index {
+        public:
+            /// Builds the index over `n_rows` rows stored in `columns` (most significant first).
+            composite_index( const std::vector<value_type *> & columns, std::size_t n_rows );
+
+            /// Rows whose leading `key_len` columns are equal to `key`.
+            row_range equal_range( const value_type * key, std::size_t key_len ) const;
+
+            /// First row whose leading `key_len` columns are _not less_ than `key`, or `n_rows()`.
+            std::size_t lbound( const value_type * key, std::size_t key_len ) const;
+
+            /// First row whose leading `key_len` columns are _greater_ than `key`, or `n_rows()`.
+            std::size_t ubound( const value_type * key, std::size_t key_len ) const;
+
+            /// Batch `equal_range()`: `keys` holds `n_queries` keys of `key_len` components each, one after the other.
+            void equal_range( const value_type * keys, std::size_t key_len, std::size_t n_queries, row_range * out ) const;
+
+            /// Batch `lbound()`: `keys` holds `n_queries` keys of `key_len` components each, one after the other.
+            void lbound( const value_type * keys, std::size_t key_len, std::size_t n_queries, std::size_t * out ) const;
+
+            /// Batch `ubound()`: `keys` holds `n_queries` keys of `key_len` components each, one after the other.
+            void ubound( const value_type * keys, std::size_t key_len, std::size_t n_queries, std::size_t * out ) const;
+
+            /// Number of rows.
+            std::size_t n_rows( void ) const { return m_n_rows; }
+
+            /// Number of key columns.
+            std::size_t n_columns( void ) const { return m_columns.size(); }
+
+        private:
+            std::vector<value_type *> m_columns; //!< The key columns, most significant first.
+            std::size_t m_n_rows;                //!< Number of rows.
+
+            /// Narrows `rows` to those matching the first `n` components of `key`, starting the first column at `hint`.
+            row_range narrow( const value_type * key, std::size_t n, std::size_t hint ) const;
+    };
+}
+
+#endif // COMPOSITE_H
@@ -0,0 +1,86 @@
+/*!
+ * \file cracking.cpp
+ * Implementation of the cracking index.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "cracking.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace sa {
+
+    /*!
+     * Wraps a range; nothing is done until the first query.
+     * \param first Pointer to the begining of the (unsorted) data range.
+     * \param last Pointer just past the last element of the data range.
+     */
+    cracking_index::cracking_index( value_type * first, value_type * last )
+        : m_first{ first }, m_last{ last }
+    { /* empty */ }
+
+    /*!
+     * Cracks the piece holding `value`: the nearest boundaries below and above `value` bound the
+     * only elements whose side of `value` is not known yet, and only those are partitioned.
+     * \param value The key to partition around.
+     * \return The first position whose element is _not less_ than `value`.
+     */
+    value_type * cracking_index::partition_point( value_type value )
+    {
+        if ( value == std::numeric_limits<value_type>::min() ) {
+            return m_first;
+        }
+        auto above = m_boundaries.lower_bound( value );
+        if ( above != m_boundaries.end() && above->first == value ) {
+            return m_first + above->second;
+        }
+        value_type * piece_first = above == m_boundaries.begin() ? m_first : m_first + std::prev( above )->second;
+        value_type * piece_last = above == m_boundaries.end() ? m_last : m_first + above->second;
+
+        value_type * point = std::partition( piece_first, piece_last, [value]( value_type x ) { return x < value; } );
+        m_boundaries.emplace_hint( above, value, static_cast<std::size_t>( point - m_first ) );
+        return point;
+    }
+
+    /*!
+     * Finds the elements in `[low,high)`.
+     * \param low Smallest value wanted.
+     * \param high Just past the largest value wanted.
+     * \return The sub-range holding exactly those elements (empty if `high <= low`).
+     */
+    std::pair<value_type *, value_type *> cracking_index::range( value_type low, value_type high )
+    {
+        if ( high <= low ) {
+            value_type * p = partition_point( low );
+            return std::make_pair( p, p );
+        }
+        value_type * lo = partition_point( low );
+        return std::make_pair( lo, partition_point( high ) );
+    }
+
+    /*!
+     * Counts the elements equal to `value`.
+     * \param value The value we are looking for.
+     * \return How many elements are equal to `value`.
+     */
+    std::size_t cracking_index::count( value_type value )
+    {
+        value_type * lo = partition_point( value );
+        value_type * hi = value == std::numeric_limits<value_type>::max() ? m_last : partition_point( value + 1 );
+        return static_cast<std::size_t>( hi - lo );
+    }
+
+    /*!
+     * Looks for `value`, cracking the range around it.
+     * \param value The value we are looking for.
+     * \return A pointer to an element equal to `value`, or `last` if there is none.
+     */
+    value_type * cracking_index::find( value_type value )
+    {
+        value_type * lo = partition_point( value );
+        value_type * hi = value == std::numeric_limits<value_type>::max() ? m_last : partition_point( value + 1 );
+        return lo != hi ? lo : m_last;
+    }
+}
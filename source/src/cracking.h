@@ -0,0 +1,64 @@
+/*!
+ * \file cracking.h
+ * Adaptive indexing (database cracking) of unsorted arrays.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef CRACKING_H
+#define CRACKING_H
+
+#include <cstddef>
+#include <map>
+#include <utility>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * An index over an **unsorted** range that is built by the queries themselves.
+     *
+     * Each query partitions ("cracks") the piece of the range its key falls in around that key,
+     * and records the new boundary in a tree mapping a key `v` to the position `p` such that every
+     * element before `p` is less than `v` and every element from `p` on is not. The first query
+     * costs about one scan; each later one only partitions the piece between its two nearest
+     * boundaries, so as boundaries accumulate in the queried region its cost falls toward a tree
+     * lookup plus a short partition, and the range is never sorted as a whole.
+     *
+     * \note The range is reordered **in place** (no element is added or lost); results are
+     *       pointers into it, valid until the next query reorders it again.
+     * \note Queries modify the index; a `cracking_index` must not be shared by threads without
+     *       external locking.
+     */
+    class cracking_index {
+        public:
+            /// Wraps the unsorted range `[first,last)`.
+            cracking_index( value_type * first, value_type * last );
+
+            /// Location of an element equal to `value`, or `last` if there is none (as `sa::lsearch`).
+            value_type * find( value_type value );
+
+            /// Number of elements equal to `value`.
+            std::size_t count( value_type value );
+
+            /// The sub-range holding exactly the elements in `[low,high)`, in no particular order.
+            std::pair<value_type *, value_type *> range( value_type low, value_type high );
+
+            /// Partitions around `value`: every element before the result is less than `value`, and no element after it.
+            value_type * partition_point( value_type value );
+
+            /// Number of elements.
+            std::size_t size( void ) const { return static_cast<std::size_t>( m_last - m_first ); }
+
+            /// Number of pieces the range is split into.
+            std::size_t n_pieces( void ) const { return m_boundaries.size() + 1; }
+
+        private:
+            value_type * m_first;                            //!< The range.
+            value_type * m_last;                             //!< Just past its end.
+            std::map<value_type, std::size_t> m_boundaries;  //!< Key -> position of its partition point.
+    };
+}
+
+#endif // CRACKING_H
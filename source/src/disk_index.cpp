@@ -0,0 +1,482 @@
+/*!
+ * \file disk_index.cpp
+ * Implementation of the external-memory search engine, with its io_uring and pread backends.
+ *
+ * The ring is driven through the raw `io_uring_setup`/`io_uring_enter` system calls, so no
+ * extra library is needed; on other systems, or when the kernel refuses to create a ring
+ * (old kernel, seccomp, ...) or cannot read through it (no `IORING_OP_READ` before Linux 5.6),
+ * batches fall back to concurrent `pread`s.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "disk_index.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define SA_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace sa {
+
+#if defined(SA_HAVE_IO_URING)
+    /// A minimal io_uring: the shared submission and completion rings, mapped from the kernel.
+    struct disk_index::ring_t {
+        int fd;                 //!< The ring file descriptor.
+        unsigned entries;       //!< Submission queue entries.
+        unsigned * sq_tail;     //!< Submission queue tail (written by us).
+        unsigned * sq_mask;     //!< Submission queue index mask.
+        unsigned * sq_array;    //!< Submission queue indirection array.
+        unsigned * cq_head;     //!< Completion queue head (written by us).
+        unsigned * cq_tail;     //!< Completion queue tail (written by the kernel).
+        unsigned * cq_mask;     //!< Completion queue index mask.
+        io_uring_sqe * sqes;    //!< Submission queue entries.
+        io_uring_cqe * cqes;    //!< Completion queue entries.
+        void * sq_ptr;          //!< Mapping of the submission ring.
+        std::size_t sq_len;     //!< Length of `sq_ptr`.
+        void * cq_ptr;          //!< Mapping of the completion ring (may be `sq_ptr`).
+        std::size_t cq_len;     //!< Length of `cq_ptr`.
+        std::size_t sqes_len;   //!< Length of the `sqes` mapping.
+
+        /// Sets up a ring with (at least) `depth` entries, or returns `nullptr` if the kernel refuses.
+        static ring_t * create( unsigned depth )
+        {
+            io_uring_params params;
+            std::memset( &params, 0, sizeof(params) );
+            int fd = static_cast<int>( syscall( __NR_io_uring_setup, depth, &params ) );
+            if ( fd < 0 ) {
+                return nullptr;
+            }
+
+            ring_t * ring = new ring_t;
+            ring->fd = fd;
+            ring->entries = params.sq_entries;
+            ring->sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            ring->cq_len = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+            if ( single_mmap ) {
+                ring->sq_len = ring->cq_len = std::max( ring->sq_len, ring->cq_len );
+            }
+            ring->sqes_len = params.sq_entries * sizeof(io_uring_sqe);
+
+            ring->sq_ptr = mmap( nullptr, ring->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+            ring->cq_ptr = single_mmap ? ring->sq_ptr
+                : mmap( nullptr, ring->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+            void * sqes = mmap( nullptr, ring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+            if ( ring->sq_ptr == MAP_FAILED || ring->cq_ptr == MAP_FAILED || sqes == MAP_FAILED ) {
+                if ( sqes != MAP_FAILED ) munmap( sqes, ring->sqes_len );
+                if ( not single_mmap && ring->cq_ptr != MAP_FAILED ) munmap( ring->cq_ptr, ring->cq_len );
+                if ( ring->sq_ptr != MAP_FAILED ) munmap( ring->sq_ptr, ring->sq_len );
+                close( fd );
+                delete ring;
+                return nullptr;
+            }
+
+            char * sq = static_cast<char*>( ring->sq_ptr );
+            char * cq = static_cast<char*>( ring->cq_ptr );
+            ring->sq_tail  = reinterpret_cast<unsigned*>( sq + params.sq_off.tail );
+            ring->sq_mask  = reinterpret_cast<unsigned*>( sq + params.sq_off.ring_mask );
+            ring->sq_array = reinterpret_cast<unsigned*>( sq + params.sq_off.array );
+            ring->cq_head  = reinterpret_cast<unsigned*>( cq + params.cq_off.head );
+            ring->cq_tail  = reinterpret_cast<unsigned*>( cq + params.cq_off.tail );
+            ring->cq_mask  = reinterpret_cast<unsigned*>( cq + params.cq_off.ring_mask );
+            ring->cqes     = reinterpret_cast<io_uring_cqe*>( cq + params.cq_off.cqes );
+            ring->sqes     = static_cast<io_uring_sqe*>( sqes );
+            return ring;
+        }
+
+        /// Unmaps the rings and closes the ring descriptor.
+        void destroy( void )
+        {
+            munmap( sqes, sqes_len );
+            if ( cq_ptr != sq_ptr ) {
+                munmap( cq_ptr, cq_len );
+            }
+            munmap( sq_ptr, sq_len );
+            close( fd );
+        }
+
+        /// Queues a read of `len` bytes at `offset` of `file` into `buffer`, tagged with `tag`.
+        void push_read( int file, void * buffer, unsigned len, std::uint64_t offset, std::uint64_t tag )
+        {
+            unsigned tail = *sq_tail;
+            unsigned index = tail & *sq_mask;
+            io_uring_sqe * sqe = &sqes[index];
+            std::memset( sqe, 0, sizeof(*sqe) );
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = file;
+            sqe->addr = reinterpret_cast<std::uint64_t>( buffer );
+            sqe->len = len;
+            sqe->off = offset;
+            sqe->user_data = tag;
+            sq_array[index] = index;
+            __atomic_store_n( sq_tail, tail + 1, __ATOMIC_RELEASE );
+        }
+
+        /*!
+         * Submits up to `to_submit` queued reads and waits for at least one completion.
+         * \return The number of reads the kernel took; the others stay queued.
+         * \throw std::system_error if the kernel refuses the call.
+         */
+        unsigned enter( unsigned to_submit )
+        {
+            long submitted;
+            while ( ( submitted = syscall( __NR_io_uring_enter, fd, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0 ) ) < 0 ) {
+                if ( errno != EINTR ) {
+                    throw std::system_error( errno, std::generic_category(), "disk_index: io_uring_enter" );
+                }
+            }
+            return static_cast<unsigned>( submitted );
+        }
+    };
+#else
+    /// No io_uring on this system.
+    struct disk_index::ring_t {
+        static ring_t * create( unsigned ) { return nullptr; }
+        void destroy( void ) {}
+    };
+#endif
+
+    disk_index::disk_index( const std::string & path, io_backend_t backend, std::size_t block_bytes, unsigned queue_depth, unsigned n_threads )
+        : m_fd{ -1 }, m_size{ 0 }, m_block_keys{ std::max<std::size_t>( 1, block_bytes / sizeof(value_type) ) },
+          m_backend{ io_backend_t::PREAD }, m_queue_depth{ std::max( queue_depth, 1u ) },
+          m_n_threads{ std::max( n_threads, 1u ) }, m_ring{ nullptr }
+    {
+        m_fd = open( path.c_str(), O_RDONLY );
+        if ( m_fd < 0 ) {
+            throw std::system_error( errno, std::generic_category(), "disk_index: cannot open " + path );
+        }
+        struct stat info;
+        if ( fstat( m_fd, &info ) != 0 ) {
+            int error = errno;
+            close( m_fd );
+            throw std::system_error( error, std::generic_category(), "disk_index: cannot stat " + path );
+        }
+        m_size = static_cast<std::uint64_t>( info.st_size ) / sizeof(value_type);
+
+        // The fences: the first key of every block.
+        const std::uint64_t n_blocks = ( m_size + m_block_keys - 1 ) / m_block_keys;
+        m_fences.resize( n_blocks );
+        for ( std::uint64_t b{0} ; b < n_blocks ; ++b ) {
+            const off_t offset = static_cast<off_t>( b * m_block_keys * sizeof(value_type) );
+            if ( pread( m_fd, &m_fences[b], sizeof(value_type), offset ) != static_cast<ssize_t>( sizeof(value_type) ) ) {
+                int error = errno;
+                close( m_fd );
+                throw std::system_error( error, std::generic_category(), "disk_index: cannot read " + path );
+            }
+        }
+
+        if ( backend != io_backend_t::PREAD ) {
+            m_ring = ring_t::create( m_queue_depth );
+            if ( m_ring != nullptr ) {
+                m_backend = io_backend_t::IO_URING;
+            }
+        }
+    }
+
+    disk_index::~disk_index( void )
+    {
+        drop_ring();
+        close( m_fd );
+    }
+
+    std::uint64_t disk_index::block_of( value_type value ) const
+    {
+        // The last block whose first key is less than `value` (or the first block).
+        value_type* fences = const_cast<value_type*>( m_fences.data() );
+        std::uint64_t before = static_cast<std::uint64_t>( sa::lbound( fences, fences + m_fences.size(), value ) - fences );
+        return before == 0 ? 0 : before - 1;
+    }
+
+    std::size_t disk_index::keys_in( std::uint64_t b ) const
+    {
+        return static_cast<std::size_t>( std::min<std::uint64_t>( m_block_keys, m_size - b * m_block_keys ) );
+    }
+
+    void disk_index::drop_ring( void )
+    {
+        if ( m_ring != nullptr ) {
+            m_ring->destroy();
+            delete m_ring;
+            m_ring = nullptr;
+        }
+        m_backend = io_backend_t::PREAD;
+    }
+
+    void disk_index::read_block( std::uint64_t b, value_type * buffer ) const
+    {
+        char * dest = reinterpret_cast<char*>( buffer );
+        std::size_t remaining = keys_in( b ) * sizeof(value_type);
+        off_t offset = static_cast<off_t>( b * m_block_keys * sizeof(value_type) );
+
+        while ( remaining > 0 ) {
+            ssize_t n = pread( m_fd, dest, remaining, offset );
+            if ( n < 0 && errno == EINTR ) {
+                continue;
+            }
+            if ( n <= 0 ) {
+                throw std::system_error( n < 0 ? errno : EIO, std::generic_category(), "disk_index: pread" );
+            }
+            dest += n;
+            offset += n;
+            remaining -= static_cast<std::size_t>( n );
+        }
+    }
+
+    std::uint64_t disk_index::resolve( std::uint64_t b, value_type * buffer, value_type value, bool exact ) const
+    {
+        const std::size_t n = keys_in( b );
+        value_type* lb = sa::lbound( buffer, buffer + n, value );
+        std::uint64_t index = b * m_block_keys + static_cast<std::uint64_t>( lb - buffer );
+
+        if ( not exact ) {
+            return index;
+        }
+        if ( lb != buffer + n ) {
+            return *lb == value ? index : m_size;
+        }
+        // The lower bound is the first key of the next block, which we know from the fences.
+        return ( b + 1 < m_fences.size() && m_fences[b + 1] == value ) ? index : m_size;
+    }
+
+    /*!
+     * Returns the index of the first key in the file that is _not less_ than `value`, or `size()` if there is no such key.
+     * Reads a single block with a blocking `pread`.
+     * \param value The value we are looking for.
+     */
+    std::uint64_t disk_index::lbound( value_type value ) const
+    {
+        if ( m_size == 0 ) {
+            return 0;
+        }
+        std::uint64_t b = block_of( value );
+        std::vector<value_type> buffer( m_block_keys );
+        read_block( b, buffer.data() );
+        return resolve( b, buffer.data(), value, false );
+    }
+
+    /*!
+     * Returns the index of a key equal to `value`, or `size()` if no such key is found.
+     * Reads a single block with a blocking `pread`.
+     * \param value The value we are looking for.
+     */
+    std::uint64_t disk_index::find( value_type value ) const
+    {
+        if ( m_size == 0 ) {
+            return 0;
+        }
+        std::uint64_t b = block_of( value );
+        std::vector<value_type> buffer( m_block_keys );
+        read_block( b, buffer.data() );
+        return resolve( b, buffer.data(), value, true );
+    }
+
+    /*!
+     * Batch version of `lbound()`: each distinct leaf block is read once, and the reads are issued concurrently.
+     * \param qfirst Pointer to the begining of the queries.
+     * \param qlast Pointer just past the last query.
+     * \param out Receives one index per query.
+     */
+    void disk_index::lbound( const value_type * qfirst, const value_type * qlast, std::uint64_t * out )
+    {
+        batch( qfirst, qlast, out, false );
+    }
+
+    /*!
+     * Batch version of `find()`: each distinct leaf block is read once, and the reads are issued concurrently.
+     * \param qfirst Pointer to the begining of the queries.
+     * \param qlast Pointer just past the last query.
+     * \param out Receives one index per query.
+     */
+    void disk_index::find( const value_type * qfirst, const value_type * qlast, std::uint64_t * out )
+    {
+        batch( qfirst, qlast, out, true );
+    }
+
+    void disk_index::batch( const value_type * qfirst, const value_type * qlast, std::uint64_t * out, bool exact )
+    {
+        const std::size_t n_queries = static_cast<std::size_t>( qlast - qfirst );
+        if ( m_size == 0 ) {
+            std::fill( out, out + n_queries, std::uint64_t{0} );
+            return;
+        }
+
+        // Route every query to its block in memory, then group the queries by block.
+        std::vector< std::pair<std::uint64_t, std::size_t> > routed( n_queries );
+        for ( std::size_t q{0} ; q < n_queries ; ++q ) {
+            routed[q] = std::make_pair( block_of( qfirst[q] ), q );
+        }
+        std::sort( routed.begin(), routed.end() );
+        std::vector<std::size_t> groups;  // Start of each group of queries sharing a block in `routed`.
+        for ( std::size_t i{0} ; i < n_queries ; ++i ) {
+            if ( i == 0 || routed[i].first != routed[i-1].first ) {
+                groups.push_back( i );
+            }
+        }
+        groups.push_back( n_queries );
+        const std::size_t n_groups = groups.size() - 1;
+
+        // Answers every query of group `g`, whose block is in `buffer`.
+        auto answer = [&]( std::size_t g, value_type * buffer ) {
+            for ( std::size_t i = groups[g] ; i < groups[g + 1] ; ++i ) {
+                out[ routed[i].second ] = resolve( routed[i].first, buffer, qfirst[ routed[i].second ], exact );
+            }
+        };
+
+#if defined(SA_HAVE_IO_URING)
+        if ( m_ring != nullptr ) {
+            const unsigned depth = std::min( m_queue_depth, m_ring->entries );
+            std::vector<value_type> buffers( depth * m_block_keys );
+            std::vector<unsigned> free_slots;
+            for ( unsigned s{0} ; s < depth ; ++s ) {
+                free_slots.push_back( s );
+            }
+
+            // On any failure we stop queuing reads, but still wait for those in flight before
+            // leaving, since the kernel writes into `buffers` until they complete.
+            std::exception_ptr error;
+            bool unsupported{false};     // The kernel has rings, but cannot read through them.
+            bool enter_failed{false};    // The ring itself failed; reads may be left queued in it.
+            std::size_t next{0};
+            unsigned queued{0}, in_flight{0};
+            while ( ( next < n_groups && not error && not unsupported ) || queued > 0 || in_flight > 0 ) {
+                // Keep the queue full.
+                while ( not free_slots.empty() && next < n_groups && not error && not unsupported ) {
+                    unsigned slot = free_slots.back();
+                    free_slots.pop_back();
+                    std::uint64_t b = routed[ groups[next] ].first;
+                    m_ring->push_read( m_fd, &buffers[ slot * m_block_keys ],
+                                       static_cast<unsigned>( keys_in( b ) * sizeof(value_type) ),
+                                       b * m_block_keys * sizeof(value_type), next * depth + slot );
+                    ++next;
+                    ++queued;
+                }
+                try {
+                    const unsigned submitted = m_ring->enter( enter_failed ? 0 : queued );
+                    queued -= submitted;
+                    in_flight += submitted;
+                }
+                catch ( ... ) {
+                    if ( enter_failed ) {
+                        // Cannot even wait: the reads in flight may still land in `buffers`, so
+                        // leave them to the kernel rather than free them.
+                        new std::vector<value_type>( std::move( buffers ) );
+                        break;
+                    }
+                    error = std::current_exception();
+                    enter_failed = true;
+                    queued = 0;  // Left in the ring, which is dropped below.
+                }
+
+                // Answer the queries of every block that arrived.
+                unsigned head = *m_ring->cq_head;
+                const unsigned tail = __atomic_load_n( m_ring->cq_tail, __ATOMIC_ACQUIRE );
+                for ( ; head != tail ; ++head ) {
+                    const io_uring_cqe & cqe = m_ring->cqes[ head & *m_ring->cq_mask ];
+                    const std::size_t g = static_cast<std::size_t>( cqe.user_data / depth );
+                    const unsigned slot = static_cast<unsigned>( cqe.user_data % depth );
+                    value_type * buffer = &buffers[ slot * m_block_keys ];
+                    const std::uint64_t b = routed[ groups[g] ].first;
+
+                    if ( cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP ) {
+                        unsupported = true;  // e.g. no IORING_OP_READ before Linux 5.6.
+                    }
+                    else if ( not error && not unsupported ) {
+                        try {
+                            if ( cqe.res < 0 ) {
+                                throw std::system_error( -cqe.res, std::generic_category(), "disk_index: io_uring read" );
+                            }
+                            if ( static_cast<std::size_t>( cqe.res ) < keys_in( b ) * sizeof(value_type) ) {
+                                read_block( b, buffer );  // Short read: finish it synchronously.
+                            }
+                            answer( g, buffer );
+                        }
+                        catch ( ... ) {
+                            error = std::current_exception();
+                        }
+                    }
+                    free_slots.push_back( slot );
+                    --in_flight;
+                }
+                __atomic_store_n( m_ring->cq_head, head, __ATOMIC_RELEASE );
+            }
+
+            if ( enter_failed || unsupported ) {
+                drop_ring();
+            }
+            if ( error ) {
+                std::rethrow_exception( error );
+            }
+            if ( not unsupported ) {
+                return;
+            }
+            // The ring cannot read: redo the whole batch with preads, now and from now on.
+        }
+#endif
+
+        // pread backend: worker threads take the groups in turns.
+        const unsigned n_workers = static_cast<unsigned>( std::min<std::size_t>( m_n_threads, n_groups ) );
+        std::vector<std::exception_ptr> errors( n_workers );
+        auto work = [&]( unsigned w ) {
+            try {
+                std::vector<value_type> buffer( m_block_keys );
+                for ( std::size_t g = w ; g < n_groups ; g += n_workers ) {
+                    read_block( routed[ groups[g] ].first, buffer.data() );
+                    answer( g, buffer.data() );
+                }
+            }
+            catch ( ... ) {
+                errors[w] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for ( unsigned w{1} ; w < n_workers ; ++w ) {
+            workers.push_back( std::thread( work, w ) );
+        }
+        if ( n_workers > 0 ) {
+            work( 0 );
+        }
+        for ( auto & t : workers ) {
+            t.join();
+        }
+        for ( const auto & e : errors ) {
+            if ( e ) {
+                std::rethrow_exception( e );
+            }
+        }
+    }
+
+    /*!
+     * Writes `[first;last)` to `path` as raw `value_type`s, the format `disk_index` reads.
+     * \param path The file to (over)write.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \throw std::system_error if the file cannot be written.
+     */
+    void disk_index::write( const std::string & path, const value_type * first, const value_type * last )
+    {
+        std::ofstream file( path, std::ios::binary | std::ios::trunc );
+        file.write( reinterpret_cast<const char*>( first ), static_cast<std::streamsize>( ( last - first ) * sizeof(value_type) ) );
+        if ( not file ) {
+            throw std::system_error( EIO, std::generic_category(), "disk_index: cannot write " + path );
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*!
+ * \file disk_index.h
+ * Search over a sorted file of integers that may be larger than RAM.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef DISK_INDEX_H
+#define DISK_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * External-memory search engine over a file holding a sorted array of `value_type` (raw,
+     * native byte order), e.g. one written by `disk_index::write()`.
+     *
+     * The file is split into fixed-size blocks. The first key of every block (the _fences_) is kept
+     * in memory, so the upper levels of the search never touch the disk: a query is routed to its
+     * leaf block with `sa::lbound` over the fences, and only that block is read.
+     *
+     * Batches read their distinct leaf blocks asynchronously: with `io_uring` (when the kernel
+     * allows it) up to `queue_depth` reads are in flight at once; otherwise a few worker threads
+     * issue blocking `pread`s concurrently. Throughput is then bounded by device IOPS rather than
+     * by the latency of each query.
+     *
+     * \note Batch searches reuse internal buffers and the ring; a `disk_index` must not be shared
+     *       by threads without external locking.
+     */
+    class disk_index {
+        public:
+            /// How leaf blocks are read by the batch searches.
+            enum class io_backend_t : int {
+                AUTO,      //!< `IO_URING` if available, `PREAD` otherwise.
+                IO_URING,  //!< Asynchronous reads through `io_uring`; falls back to `PREAD` if the kernel refuses it or cannot read through it.
+                PREAD      //!< Blocking `pread`s spread over worker threads.
+            };
+
+            /*!
+             * Opens `path` and loads its fences.
+             * \param path The sorted key file.
+             * \param backend How batches read their leaf blocks.
+             * \param block_bytes Size of a leaf block; rounded to a multiple of `sizeof(value_type)`.
+             * \param queue_depth Maximum number of reads in flight (io_uring backend).
+             * \param n_threads Number of reader threads (pread backend).
+             * \throw std::system_error if the file cannot be opened or read.
+             */
+            explicit disk_index( const std::string & path, io_backend_t backend=io_backend_t::AUTO,
+                                 std::size_t block_bytes=4096, unsigned queue_depth=256, unsigned n_threads=8 );
+            ~disk_index( void );
+
+            disk_index( const disk_index & ) = delete;
+            disk_index & operator=( const disk_index & ) = delete;
+
+            /// Index of the first key _not less_ than `value`, or `size()`.
+            std::uint64_t lbound( value_type value ) const;
+
+            /// Index of a key equal to `value`, or `size()` if there is none.
+            std::uint64_t find( value_type value ) const;
+
+            /// Batch `lbound()`: stores one index per query of `[qfirst,qlast)` in `out`.
+            void lbound( const value_type * qfirst, const value_type * qlast, std::uint64_t * out );
+
+            /// Batch `find()`: stores one index per query of `[qfirst,qlast)` in `out`.
+            void find( const value_type * qfirst, const value_type * qlast, std::uint64_t * out );
+
+            /// Number of keys in the file.
+            std::uint64_t size( void ) const { return m_size; }
+
+            /// The backend actually used by the batch searches.
+            io_backend_t backend( void ) const { return m_backend; }
+
+            /// Bytes of the in-memory part of the index.
+            std::size_t memory_bytes( void ) const { return m_fences.size() * sizeof(value_type); }
+
+            /// Writes `[first,last)` to `path` in the format read by `disk_index`.
+            static void write( const std::string & path, const value_type * first, const value_type * last );
+
+        private:
+            struct ring_t;  //!< The io_uring instance (opaque, Linux only).
+
+            int m_fd;                            //!< The key file.
+            std::uint64_t m_size;                //!< Number of keys in the file.
+            std::size_t m_block_keys;            //!< Keys per leaf block.
+            std::vector<value_type> m_fences;    //!< First key of every block.
+            io_backend_t m_backend;              //!< Backend in use.
+            unsigned m_queue_depth;              //!< Reads in flight (io_uring).
+            unsigned m_n_threads;                //!< Reader threads (pread).
+            ring_t * m_ring;                     //!< The ring, or `nullptr`.
+
+            /// Block a query must read to resolve its lower bound.
+            std::uint64_t block_of( value_type value ) const;
+            /// Tears the ring down, if any, and switches to `PREAD`.
+            void drop_ring( void );
+            /// Number of keys in block `b`.
+            std::size_t keys_in( std::uint64_t b ) const;
+            /// Reads block `b` into `buffer` with a blocking `pread`.
+            void read_block( std::uint64_t b, value_type * buffer ) const;
+            /// Resolves a query inside the block `b` held in `buffer`.
+            std::uint64_t resolve( std::uint64_t b, value_type * buffer, value_type value, bool exact ) const;
+            /// Shared by the batch searches.
+            void batch( const value_type * qfirst, const value_type * qlast, std::uint64_t * out, bool exact );
+    };
+}
+
+#endif // DISK_INDEX_H
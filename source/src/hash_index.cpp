@@ -0,0 +1,211 @@
+/*!
+ * \file hash_index.cpp
+ * Implementation of the static exact-match hash index.
+ * \date October 19th, 2026.
+ */
+
+#include "hash_index.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace sa {
+
+    const std::uint32_t hash_index::empty;
+
+    namespace {
+
+        /// Mixes the bits of `key` with `seed` (the 64-bit finalizer from MurmurHash3).
+        inline std::uint64_t mix( value_type key, std::uint64_t seed )
+        {
+            std::uint64_t h = static_cast<std::uint32_t>( key ) ^ ( seed * 0x9E3779B97F4A7C15ull );
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /// Maps a hash onto `[0,n)` without a division.
+        inline std::uint64_t reduce( std::uint64_t h, std::uint64_t n )
+        {
+            return ( ( h >> 32 ) * n ) >> 32;
+        }
+
+        /// Perfect hashing: average number of keys per bucket.
+        const std::size_t keys_per_bucket{ 4 };
+        /// Perfect hashing: tries per bucket before the table is grown.
+        const std::uint32_t max_displacements{ 1u << 16 };
+    }
+
+    /*!
+     * Builds the index over `[first;last)`.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param layout The table layout.
+     * \throw std::length_error if the range has 2^32 - 1 elements or more.
+     */
+    hash_index::hash_index( value_type * first, value_type * last, layout_t layout )
+        : m_first{ first }, m_last{ last }, m_layout{ layout }, m_size{ 0 }, m_mask{ 0 }
+    {
+        if ( static_cast<std::uint64_t>( last - first ) >= empty ) {
+            throw std::length_error( "hash_index: range too large" );
+        }
+
+        if ( layout == layout_t::PERFECT ) {
+            build_perfect();
+        }
+        else {
+            build_open_addressing();
+        }
+    }
+
+    void hash_index::build_open_addressing( void )
+    {
+        const std::size_t n = static_cast<std::size_t>( m_last - m_first );
+
+        // Power of two, at most half full.
+        std::size_t capacity{ 2 };
+        while ( capacity < 2 * n ) {
+            capacity *= 2;
+        }
+        m_mask = capacity - 1;
+        m_slots.assign( capacity, slot_t{ 0, empty } );
+
+        for ( std::size_t i{0} ; i < n ; ++i ) {
+            std::uint64_t s = mix( m_first[i], 0 ) & m_mask;
+            while ( m_slots[s].pos != empty && m_slots[s].key != m_first[i] ) {
+                s = ( s + 1 ) & m_mask;
+            }
+            if ( m_slots[s].pos == empty ) {
+                m_slots[s] = slot_t{ m_first[i], static_cast<std::uint32_t>( i ) };
+                ++m_size;
+            }
+        }
+    }
+
+    void hash_index::build_perfect( void )
+    {
+        const std::size_t n = static_cast<std::size_t>( m_last - m_first );
+
+        // Distinct keys, each with its first position.
+        std::vector< std::pair<value_type, std::uint32_t> > keys;
+        keys.reserve( n );
+        for ( std::size_t i{0} ; i < n ; ++i ) {
+            keys.push_back( std::make_pair( m_first[i], static_cast<std::uint32_t>( i ) ) );
+        }
+        std::stable_sort( keys.begin(), keys.end(),
+                [](const std::pair<value_type, std::uint32_t>& a, const std::pair<value_type, std::uint32_t>& b )->bool
+                { return a.first < b.first; } );
+        keys.erase( std::unique( keys.begin(), keys.end(),
+                [](const std::pair<value_type, std::uint32_t>& a, const std::pair<value_type, std::uint32_t>& b )->bool
+                { return a.first == b.first; } ), keys.end() );
+        m_size = keys.size();
+
+        const std::size_t n_buckets = std::max<std::size_t>( 1, ( m_size + keys_per_bucket - 1 ) / keys_per_bucket );
+        std::size_t n_slots = std::max<std::size_t>( 1, m_size + m_size / 8 );
+
+        // Group keys by bucket, then place the largest buckets first while the table is still empty.
+        std::vector< std::vector<std::size_t> > buckets( n_buckets );
+        for ( std::size_t k{0} ; k < m_size ; ++k ) {
+            buckets[ reduce( mix( keys[k].first, 0 ), n_buckets ) ].push_back( k );
+        }
+        std::vector<std::size_t> order( n_buckets );
+        for ( std::size_t b{0} ; b < n_buckets ; ++b ) {
+            order[b] = b;
+        }
+        std::stable_sort( order.begin(), order.end(),
+                [&buckets](std::size_t a, std::size_t b )->bool
+                { return buckets[a].size() > buckets[b].size(); } );
+
+        std::vector<std::uint64_t> placed;
+        for ( ;; ) {
+            m_slots.assign( n_slots, slot_t{ 0, empty } );
+            m_displ.assign( n_buckets, 0 );
+            bool done{true};
+
+            for ( std::size_t b : order ) {
+                if ( buckets[b].empty() ) {
+                    break;
+                }
+                // Look for a seed that sends every key of this bucket to a distinct free slot.
+                std::uint32_t d{1};
+                for ( ; d < max_displacements ; ++d ) {
+                    placed.clear();
+                    bool fits{true};
+                    for ( std::size_t k : buckets[b] ) {
+                        std::uint64_t s = reduce( mix( keys[k].first, d ), n_slots );
+                        if ( m_slots[s].pos != empty || std::find( placed.begin(), placed.end(), s ) != placed.end() ) {
+                            fits = false;
+                            break;
+                        }
+                        placed.push_back( s );
+                    }
+                    if ( fits ) {
+                        break;
+                    }
+                }
+                if ( d == max_displacements ) {
+                    done = false;  // Grow the table and start over.
+                    break;
+                }
+                m_displ[b] = d;
+                for ( std::size_t i{0} ; i < placed.size() ; ++i ) {
+                    const auto & key = keys[ buckets[b][i] ];
+                    m_slots[ placed[i] ] = slot_t{ key.first, key.second };
+                }
+            }
+            if ( done ) {
+                break;
+            }
+            n_slots += n_slots / 4 + 1;
+        }
+    }
+
+    /*!
+     * Looks up `value`.
+     * \param value The value we are looking for.
+     * \return A pointer to the location of `value` in the indexed range, or `last` if no such element is found.
+     */
+    value_type * hash_index::find( value_type value ) const
+    {
+        if ( m_size == 0 ) {
+            return m_last;
+        }
+
+        if ( m_layout == layout_t::PERFECT ) {
+            std::uint32_t d = m_displ[ reduce( mix( value, 0 ), m_displ.size() ) ];
+            const slot_t & slot = m_slots[ reduce( mix( value, d ), m_slots.size() ) ];
+            return ( slot.pos != empty && slot.key == value ) ? m_first + slot.pos : m_last;
+        }
+
+        std::uint64_t s = mix( value, 0 ) & m_mask;
+        while ( m_slots[s].pos != empty ) {
+            if ( m_slots[s].key == value ) {
+                return m_first + m_slots[s].pos;
+            }
+            s = ( s + 1 ) & m_mask;
+        }
+        return m_last;
+    }
+
+    /*!
+     * Looks up every value in `[qfirst,qlast)`.
+     * \param qfirst Pointer to the begining of the queries.
+     * \param qlast Pointer just past the last query.
+     * \param out Receives one result per query; must have room for `qlast - qfirst` pointers.
+     */
+    void hash_index::find( const value_type * qfirst, const value_type * qlast, value_type ** out ) const
+    {
+        while ( qfirst != qlast ) {
+            *out++ = find( *qfirst++ );
+        }
+    }
+
+    std::size_t hash_index::memory_bytes( void ) const
+    {
+        return m_slots.size() * sizeof( slot_t ) + m_displ.size() * sizeof( std::uint32_t );
+    }
+}
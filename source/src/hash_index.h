@@ -0,0 +1,85 @@
+/*!
+ * \file hash_index.h
+ * A static hash index for exact-match (point) lookups over an array of integers.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef HASH_INDEX_H
+#define HASH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * Exact-match index built once over a (non-owned) range of integers.
+     *
+     * Lookups return the same kind of result as `sa::bsearch`: a pointer into the original
+     * range, or `last` if the key is absent. Unlike `bsearch`, the range need not be sorted,
+     * and a lookup costs O(1) expected memory accesses instead of log2(n).
+     *
+     * Two layouts are available:
+     *  + `OPEN_ADDRESSING`: linear probing over a table at most half full; a lookup usually
+     *    touches a single cache line.
+     *  + `PERFECT`: a hash-and-displace perfect hash, where each key owns exactly one slot, so
+     *    a lookup reads one small displacement entry and exactly one slot. Slower to build.
+     *
+     * \note If a key is repeated, the index points to its first occurrence in the range.
+     * \note The range must outlive the index and must not be modified while in use.
+     */
+    class hash_index {
+        public:
+            /// Table layouts.
+            enum class layout_t : int { OPEN_ADDRESSING, PERFECT };
+
+            /// Builds the index over `[first,last)`.
+            hash_index( value_type * first, value_type * last, layout_t layout=layout_t::OPEN_ADDRESSING );
+
+            /// Returns a pointer to the element equal to `value`, or `last` if there is none.
+            value_type * find( value_type value ) const;
+
+            /// Looks up every value in `[qfirst,qlast)`, storing each result (as in `find()`) in `out`.
+            void find( const value_type * qfirst, const value_type * qlast, value_type ** out ) const;
+
+            /// Whether `value` is in the indexed range.
+            bool contains( value_type value ) const { return find( value ) != m_last; }
+
+            /// Number of distinct keys indexed.
+            std::size_t size( void ) const { return m_size; }
+
+            /// Bytes used by the index, not counting the indexed range.
+            std::size_t memory_bytes( void ) const;
+
+            /// The layout in use.
+            layout_t layout( void ) const { return m_layout; }
+
+        private:
+            /// A table slot: the key, and its position in the range.
+            struct slot_t {
+                value_type key;     //!< The key stored in this slot.
+                std::uint32_t pos;  //!< Offset of `key` from `first`, or `empty` if the slot is free.
+            };
+            /// Marks an unused slot.
+            static const std::uint32_t empty = 0xFFFFFFFFu;
+
+            value_type * m_first;                //!< Beginning of the indexed range.
+            value_type * m_last;                 //!< Just past the end of the indexed range.
+            layout_t m_layout;                   //!< Table layout.
+            std::size_t m_size;                  //!< Number of distinct keys.
+            std::vector<slot_t> m_slots;         //!< The table.
+            std::uint64_t m_mask;                //!< `m_slots.size() - 1` (open addressing only).
+            std::vector<std::uint32_t> m_displ;  //!< Per-bucket displacement seeds (perfect hashing only).
+
+            /// Builds the linear probing table.
+            void build_open_addressing( void );
+            /// Builds the perfect hash table.
+            void build_perfect( void );
+    };
+}
+
+#endif // HASH_INDEX_H
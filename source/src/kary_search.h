@@ -0,0 +1,28 @@
+/*!
+ * \file kary_search.h
+ * SIMD k-ary search on plain sorted arrays of integers (no layout rebuild).
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef KARY_SEARCH_H
+#define KARY_SEARCH_H
+
+#include "searching.h"
+
+namespace sa {
+
+    /// Lower bound (k-ary: compares k-1 pivots per step in one SIMD instruction).
+    value_type * kary_lbound( value_type * first, value_type * last, value_type value );
+
+    /// Upper bound (k-ary: compares k-1 pivots per step in one SIMD instruction).
+    value_type * kary_ubound( value_type * first, value_type * last, value_type value );
+
+    /// Binary search (k-ary: compares k-1 pivots per step in one SIMD instruction).
+    value_type * kary_bsearch( value_type * first, value_type * last, value_type value );
+
+    /// The instruction set the k-ary searches were compiled for: "avx2", "sse2" or "scalar".
+    const char * kary_isa( void );
+}
+
+#endif // KARY_SEARCH_H
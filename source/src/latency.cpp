@@ -0,0 +1,410 @@
+/*!
+ * \file latency.cpp
+ * Implementation of the sampled latency histograms.
+ *
+ * Every thread that records gets a block with one histogram per algorithm, linked into a global
+ * list that only ever grows (a block whose thread has exited is handed to the next new thread,
+ * counts and all). Only the owning thread writes a block, so its counters are updated with plain
+ * relaxed loads and stores, not read-modify-writes; readers merge the blocks with relaxed loads
+ * while the owners keep recording. No locks are taken anywhere.
+ *
+ * Durations are measured with `rdtsc` (fenced so the search cannot move out of the timed region)
+ * on x86, and with `std::chrono::steady_clock` elsewhere.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "latency.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SA_LATENCY_TSC 1
+#endif
+
+namespace sa {
+
+    const int latency_histogram::sub_bits;
+    const int latency_histogram::max_exponent;
+    const std::size_t latency_histogram::n_buckets;
+
+    namespace {
+
+        const char * names[ n_algorithms ] = {
+            "lsearch", "bsearch", "bsearch_rec", "lbound", "ubound",
+            "exp_bsearch", "exp_lbound", "exp_ubound", "lbound_hint", "ubound_hint"
+        };
+
+        /// Percentiles in the reports.
+        const double report_percentiles[] = { 50, 90, 99, 99.9, 99.99, 100 };
+
+        std::atomic<unsigned> sample_period{ 64 };
+
+        /// One thread's histograms.
+        struct thread_block {
+            std::atomic<bool> in_use;
+            thread_block * next;
+            std::atomic<std::uint64_t> buckets[ n_algorithms ][ latency_histogram::n_buckets ];
+        };
+
+        /// Head of the list of blocks; blocks are never freed.
+        std::atomic<thread_block *> blocks{ nullptr };
+
+        /// The calling thread's block, released when the thread exits.
+        struct block_owner {
+            thread_block * block{ nullptr };
+            unsigned countdown{ 1 };
+            ~block_owner( void ) { if ( block ) block->in_use.store( false, std::memory_order_release ); }
+        };
+
+        thread_local block_owner owner;
+
+        thread_block * acquire_block( void )
+        {
+            // Reuse the block of a thread that has exited...
+            for ( thread_block * b = blocks.load( std::memory_order_acquire ) ; b ; b = b->next ) {
+                bool free{ false };
+                if ( b->in_use.compare_exchange_strong( free, true, std::memory_order_acq_rel ) ) {
+                    return b;
+                }
+            }
+            // ... or push a new one.
+            thread_block * b = new thread_block;
+            b->in_use.store( true, std::memory_order_relaxed );
+            for ( auto & histogram : b->buckets ) {
+                for ( auto & counter : histogram ) {
+                    counter.store( 0, std::memory_order_relaxed );
+                }
+            }
+            b->next = blocks.load( std::memory_order_relaxed );
+            while ( not blocks.compare_exchange_weak( b->next, b, std::memory_order_release, std::memory_order_relaxed ) ) {
+            }
+            return b;
+        }
+
+        inline std::uint64_t start_ticks( void )
+        {
+#if defined(SA_LATENCY_TSC)
+            _mm_lfence();
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+        }
+
+        inline std::uint64_t end_ticks( void )
+        {
+#if defined(SA_LATENCY_TSC)
+            unsigned aux;
+            std::uint64_t t = __rdtscp( &aux );
+            _mm_lfence();
+            return t;
+#else
+            return start_ticks();
+#endif
+        }
+
+        /// Runs `search`, timing it if this is the sampled call of the thread's period.
+        template < typename Search >
+        inline value_type * measure( algorithm_t algorithm, Search search )
+        {
+            if ( --owner.countdown != 0 ) {
+                return search();
+            }
+            const unsigned period = sample_period.load( std::memory_order_relaxed );
+            if ( period == 0 ) {
+                owner.countdown = 1024;  // Look at the period again now and then.
+                return search();
+            }
+            owner.countdown = period;
+            if ( owner.block == nullptr ) {
+                owner.block = acquire_block();
+            }
+
+            const std::uint64_t start = start_ticks();
+            value_type * result = search();
+            const std::uint64_t end = end_ticks();
+
+            std::atomic<std::uint64_t> & counter =
+                owner.block->buckets[ static_cast<int>( algorithm ) ][ latency_histogram::bucket_of( end - start ) ];
+            counter.store( counter.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            return result;
+        }
+
+        /// "p50", "p99.9", ..., or "max" for the 100th percentile.
+        std::string percentile_label( double p )
+        {
+            if ( p == 100 ) {
+                return "max";
+            }
+            std::ostringstream label;
+            label << "p" << p;
+            return label.str();
+        }
+
+        /// Converts ticks to nanoseconds.
+        double to_ns( std::uint64_t ticks )
+        {
+            return static_cast<double>( ticks ) / latency_ticks_per_ns();
+        }
+    }
+
+    const char * to_string( algorithm_t algorithm )
+    {
+        return names[ static_cast<int>( algorithm ) ];
+    }
+
+    latency_histogram::latency_histogram( void )
+        : m_buckets( n_buckets, 0 ), m_count{ 0 }
+    { /* empty */ }
+
+    /*!
+     * Values below 2^sub_bits have a bucket each; above, a value with its highest bit at position
+     * `e` goes to bucket `(e - sub_bits + 1) * 2^sub_bits + s`, where `s` are the `sub_bits` bits
+     * below the highest one.
+     */
+    std::size_t latency_histogram::bucket_of( std::uint64_t ticks )
+    {
+        if ( ticks < ( std::uint64_t{1} << sub_bits ) ) {
+            return static_cast<std::size_t>( ticks );
+        }
+        int exponent = 63 - __builtin_clzll( ticks );
+        if ( exponent > max_exponent ) {
+            return n_buckets - 1;
+        }
+        std::size_t sub = static_cast<std::size_t>( ( ticks >> ( exponent - sub_bits ) ) & ( ( std::uint64_t{1} << sub_bits ) - 1 ) );
+        return ( static_cast<std::size_t>( exponent - sub_bits + 1 ) << sub_bits ) + sub;
+    }
+
+    std::uint64_t latency_histogram::highest_in( std::size_t bucket )
+    {
+        if ( bucket < ( std::size_t{1} << sub_bits ) ) {
+            return bucket;
+        }
+        const int exponent = static_cast<int>( bucket >> sub_bits ) + sub_bits - 1;
+        const std::uint64_t sub = bucket & ( ( std::size_t{1} << sub_bits ) - 1 );
+        return ( ( ( std::uint64_t{1} << sub_bits ) + sub + 1 ) << ( exponent - sub_bits ) ) - 1;
+    }
+
+    void latency_histogram::record( std::uint64_t ticks )
+    {
+        add( bucket_of( ticks ), 1 );
+    }
+
+    void latency_histogram::add( std::size_t bucket, std::uint64_t count )
+    {
+        m_buckets[bucket] += count;
+        m_count += count;
+    }
+
+    void latency_histogram::merge( const latency_histogram & other )
+    {
+        for ( std::size_t b{0} ; b < n_buckets ; ++b ) {
+            m_buckets[b] += other.m_buckets[b];
+        }
+        m_count += other.m_count;
+    }
+
+    void latency_histogram::clear( void )
+    {
+        std::fill( m_buckets.begin(), m_buckets.end(), 0 );
+        m_count = 0;
+    }
+
+    /*!
+     * Finds a percentile of the counted durations.
+     * \param percentile In `[0,100]`.
+     * \return The highest value of the bucket holding that percentile, or 0 if nothing was counted.
+     */
+    std::uint64_t latency_histogram::percentile( double percentile ) const
+    {
+        if ( m_count == 0 ) {
+            return 0;
+        }
+        const double fraction = std::min( 100.0, std::max( 0.0, percentile ) ) / 100;
+        const std::uint64_t rank = std::max<std::uint64_t>( 1, static_cast<std::uint64_t>( std::ceil( fraction * static_cast<double>( m_count ) ) ) );
+        std::uint64_t seen{0};
+        for ( std::size_t b{0} ; b < n_buckets ; ++b ) {
+            seen += m_buckets[b];
+            if ( seen >= rank ) {
+                return highest_in( b );
+            }
+        }
+        return highest_in( n_buckets - 1 );
+    }
+
+    void set_latency_sample_period( unsigned period )
+    {
+        sample_period.store( period, std::memory_order_relaxed );
+    }
+
+    unsigned latency_sample_period( void )
+    {
+        return sample_period.load( std::memory_order_relaxed );
+    }
+
+    /// Measured once, over 20 ms, the first time it is needed.
+    double latency_ticks_per_ns( void )
+    {
+#if defined(SA_LATENCY_TSC)
+        static const double ratio = []() {
+            auto t0 = std::chrono::steady_clock::now();
+            std::uint64_t c0 = __rdtsc();
+            while ( std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds( 20 ) ) {
+            }
+            std::uint64_t c1 = __rdtsc();
+            double ns = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - t0 ).count();
+            return static_cast<double>( c1 - c0 ) / ns;
+        }();
+        return ratio;
+#else
+        return 1.0;
+#endif
+    }
+
+    latency_histogram latency_snapshot( algorithm_t algorithm )
+    {
+        latency_histogram merged;
+        const int a = static_cast<int>( algorithm );
+        for ( thread_block * b = blocks.load( std::memory_order_acquire ) ; b ; b = b->next ) {
+            for ( std::size_t i{0} ; i < latency_histogram::n_buckets ; ++i ) {
+                std::uint64_t count = b->buckets[a][i].load( std::memory_order_relaxed );
+                if ( count != 0 ) {
+                    merged.add( i, count );
+                }
+            }
+        }
+        return merged;
+    }
+
+    void reset_latency( void )
+    {
+        for ( thread_block * b = blocks.load( std::memory_order_acquire ) ; b ; b = b->next ) {
+            for ( auto & histogram : b->buckets ) {
+                for ( auto & counter : histogram ) {
+                    counter.store( 0, std::memory_order_relaxed );
+                }
+            }
+        }
+    }
+
+    std::string latency_report_text( void )
+    {
+        std::ostringstream out;
+        out << "sample period " << latency_sample_period() << ", " << std::fixed << std::setprecision(3)
+            << latency_ticks_per_ns() << " ticks/ns\n";
+        out << std::left << std::setw(14) << "algorithm" << std::right << std::setw(12) << "samples";
+        for ( double p : report_percentiles ) {
+            out << std::setw(13) << percentile_label( p ) + "(ns)";
+        }
+        out << "\n" << std::setprecision(1);
+        for ( int a{0} ; a < n_algorithms ; ++a ) {
+            latency_histogram h = latency_snapshot( static_cast<algorithm_t>( a ) );
+            if ( h.count() == 0 ) {
+                continue;
+            }
+            out << std::left << std::setw(14) << names[a] << std::right << std::setw(12) << h.count();
+            for ( double p : report_percentiles ) {
+                out << std::setw(13) << to_ns( h.percentile( p ) );
+            }
+            out << "\n";
+        }
+        return out.str();
+    }
+
+    std::string latency_report_json( void )
+    {
+        std::ostringstream out;
+        out << std::setprecision(6) << "{\"sample_period\":" << latency_sample_period()
+            << ",\"ticks_per_ns\":" << latency_ticks_per_ns() << ",\"algorithms\":{";
+        bool first{true};
+        for ( int a{0} ; a < n_algorithms ; ++a ) {
+            latency_histogram h = latency_snapshot( static_cast<algorithm_t>( a ) );
+            if ( h.count() == 0 ) {
+                continue;
+            }
+            out << ( first ? "" : "," ) << "\"" << names[a] << "\":{\"samples\":" << h.count();
+            first = false;
+            for ( double p : report_percentiles ) {
+                out << ",\"" << percentile_label( p ) << "_ns\":" << to_ns( h.percentile( p ) );
+            }
+            // Non-empty buckets as [highest value in ns, count].
+            out << ",\"buckets\":[";
+            bool first_bucket{true};
+            for ( std::size_t b{0} ; b < latency_histogram::n_buckets ; ++b ) {
+                if ( h.at( b ) != 0 ) {
+                    out << ( first_bucket ? "" : "," ) << "[" << to_ns( latency_histogram::highest_in( b ) ) << "," << h.at( b ) << "]";
+                    first_bucket = false;
+                }
+            }
+            out << "]}";
+        }
+        out << "}}";
+        return out.str();
+    }
+
+    namespace instrumented {
+
+        value_type * lsearch( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::LSEARCH, [&]() { return sa::lsearch( first, last, value ); } );
+        }
+
+        value_type * bsearch( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::BSEARCH, [&]() { return sa::bsearch( first, last, value ); } );
+        }
+
+        value_type * bsearch_rec( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::BSEARCH_REC, [&]() { return sa::bsearch_rec( first, last, value ); } );
+        }
+
+        value_type * bsearch_rec_aux( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::BSEARCH_REC, [&]() { return sa::bsearch_rec_aux( first, last, value ); } );
+        }
+
+        value_type * lbound( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::LBOUND, [&]() { return sa::lbound( first, last, value ); } );
+        }
+
+        value_type * ubound( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::UBOUND, [&]() { return sa::ubound( first, last, value ); } );
+        }
+
+        value_type * exp_bsearch( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::EXP_BSEARCH, [&]() { return sa::exp_bsearch( first, last, value ); } );
+        }
+
+        value_type * exp_lbound( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::EXP_LBOUND, [&]() { return sa::exp_lbound( first, last, value ); } );
+        }
+
+        value_type * exp_ubound( value_type * first, value_type * last, value_type value )
+        {
+            return measure( algorithm_t::EXP_UBOUND, [&]() { return sa::exp_ubound( first, last, value ); } );
+        }
+
+        value_type * lbound_hint( value_type * first, value_type * last, value_type value, value_type * hint )
+        {
+            return measure( algorithm_t::LBOUND_HINT, [&]() { return sa::lbound_hint( first, last, value, hint ); } );
+        }
+
+        value_type * ubound_hint( value_type * first, value_type * last, value_type value, value_type * hint )
+        {
+            return measure( algorithm_t::UBOUND_HINT, [&]() { return sa::ubound_hint( first, last, value, hint ); } );
+        }
+    }
+}
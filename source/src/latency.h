@@ -0,0 +1,121 @@
+/*!
+ * \file latency.h
+ * Opt-in, sampled latency histograms for the search functions, cheap enough to leave on in production.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /// The search functions that can be instrumented.
+    enum class algorithm_t : int {
+        LSEARCH = 0, BSEARCH, BSEARCH_REC, LBOUND, UBOUND,
+        EXP_BSEARCH, EXP_LBOUND, EXP_UBOUND, LBOUND_HINT, UBOUND_HINT
+    };
+
+    /// Number of instrumented algorithms.
+    const int n_algorithms{ 10 };
+
+    /// The name of `algorithm`, as in `searching.h`.
+    const char * to_string( algorithm_t algorithm );
+
+    /*!
+     * A log-linear (HDR-style) histogram of durations in clock ticks.
+     *
+     * Each power of two is split into 32 equal buckets, so every recorded value is known to within
+     * about 3% whatever its magnitude, with a fixed number of counters. Values from 2^40 ticks up
+     * (several minutes) share the last bucket.
+     */
+    class latency_histogram {
+        public:
+            /// Sub-buckets per power of two, as a number of bits.
+            static const int sub_bits{ 5 };
+            /// Largest power of two with its own buckets.
+            static const int max_exponent{ 39 };
+            /// Number of buckets.
+            static const std::size_t n_buckets{ ( max_exponent - sub_bits + 2 ) << sub_bits };
+
+            latency_histogram( void );
+
+            /// The bucket `ticks` falls in.
+            static std::size_t bucket_of( std::uint64_t ticks );
+            /// The largest value counted by `bucket`.
+            static std::uint64_t highest_in( std::size_t bucket );
+
+            /// Counts one duration.
+            void record( std::uint64_t ticks );
+            /// Adds `count` durations to `bucket`.
+            void add( std::size_t bucket, std::uint64_t count );
+            /// Adds every count of `other`.
+            void merge( const latency_histogram & other );
+            /// Zeroes every counter.
+            void clear( void );
+
+            /// Number of durations counted.
+            std::uint64_t count( void ) const { return m_count; }
+            /// Count of `bucket`.
+            std::uint64_t at( std::size_t bucket ) const { return m_buckets[bucket]; }
+            /// The duration (in ticks) at or below which `percentile` percent of the counts fall.
+            std::uint64_t percentile( double percentile ) const;
+            /// The largest duration counted (to within a bucket).
+            std::uint64_t max( void ) const { return percentile( 100 ); }
+
+        private:
+            std::vector<std::uint64_t> m_buckets; //!< One counter per bucket.
+            std::uint64_t m_count;                //!< Sum of the counters.
+    };
+
+    /// Records one call in every `period` (per thread); 0 turns recording off. Defaults to 64.
+    void set_latency_sample_period( unsigned period );
+
+    /// The current sampling period.
+    unsigned latency_sample_period( void );
+
+    /// Clock ticks per nanosecond of the timer used (the TSC on x86, nanoseconds elsewhere).
+    double latency_ticks_per_ns( void );
+
+    /// The histogram of `algorithm`, merged over every thread that has recorded it.
+    latency_histogram latency_snapshot( algorithm_t algorithm );
+
+    /// Zeroes every thread's histograms (counts recorded concurrently may survive).
+    void reset_latency( void );
+
+    /// A human-readable table of count and percentiles (in ns) per algorithm.
+    std::string latency_report_text( void );
+
+    /// The same as `latency_report_text()`, plus the non-empty buckets, as JSON.
+    std::string latency_report_json( void );
+
+    /*!
+     * Drop-in replacements for the functions of `searching.h` that record their latency.
+     *
+     * Only one call in `latency_sample_period()` per thread is timed; the others pay for a
+     * thread-local countdown. Each thread records into its own histograms, so there is no
+     * contention, and `latency_snapshot()` merges them without stopping the writers.
+     */
+    namespace instrumented {
+        value_type * lsearch( value_type * first, value_type * last, value_type value );
+        value_type * bsearch( value_type * first, value_type * last, value_type value );
+        value_type * bsearch_rec( value_type * first, value_type * last, value_type value );
+        value_type * bsearch_rec_aux( value_type * first, value_type * last, value_type value );
+        value_type * lbound( value_type * first, value_type * last, value_type value );
+        value_type * ubound( value_type * first, value_type * last, value_type value );
+        value_type * exp_bsearch( value_type * first, value_type * last, value_type value );
+        value_type * exp_lbound( value_type * first, value_type * last, value_type value );
+        value_type * exp_ubound( value_type * first, value_type * last, value_type value );
+        value_type * lbound_hint( value_type * first, value_type * last, value_type value, value_type * hint );
+        value_type * ubound_hint( value_type * first, value_type * last, value_type value, value_type * hint );
+    }
+}
+
+#endif // LATENCY_H
@@ -0,0 +1,44 @@
+/*!
+ * \file nearest.h
+ * Predecessor, successor, nearest and k-nearest value queries on sorted arrays of integers.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef NEAREST_H
+#define NEAREST_H
+
+#include <cstddef>
+#include <utility>
+
+#include "searching.h"
+
+namespace sa {
+
+    /// Last element _less_ than `value`, or `last` if there is none.
+    value_type * predecessor( value_type * first, value_type * last, value_type value );
+
+    /// First element _greater_ than `value`, or `last` if there is none.
+    value_type * successor( value_type * first, value_type * last, value_type value );
+
+    /// Element closest to `value` (the smaller one on ties), or `last` if the range is empty.
+    value_type * nearest( value_type * first, value_type * last, value_type value );
+
+    /// The `k` elements closest to `value` (smaller ones first on ties), as a sub-range of `[first,last)`.
+    std::pair<value_type *, value_type *> k_nearest( value_type * first, value_type * last, value_type value, std::size_t k );
+
+    /// Batch `predecessor()`: stores one result per query of `[qfirst,qlast)` in `out`.
+    void predecessor( value_type * first, value_type * last, const value_type * qfirst, const value_type * qlast, value_type ** out );
+
+    /// Batch `successor()`: stores one result per query of `[qfirst,qlast)` in `out`.
+    void successor( value_type * first, value_type * last, const value_type * qfirst, const value_type * qlast, value_type ** out );
+
+    /// Batch `nearest()`: stores one result per query of `[qfirst,qlast)` in `out`.
+    void nearest( value_type * first, value_type * last, const value_type * qfirst, const value_type * qlast, value_type ** out );
+
+    /// Batch `k_nearest()`: stores one sub-range per query of `[qfirst,qlast)` in `out`.
+    void k_nearest( value_type * first, value_type * last, const value_type * qfirst, const value_type * qlast,
+                    std::size_t k, std::pair<value_type *, value_type *> * out );
+}
+
+#endif // NEAREST_H
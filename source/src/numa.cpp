@@ -0,0 +1,310 @@
+/*!
+ * \file numa.cpp
+ * Implementation of the NUMA replication and pinning helpers.
+ *
+ * Memory policies are set through the raw `mbind`, `set_mempolicy` and `move_pages` system calls, so libnuma
+ * is not needed. Node and CPU topology is read from sysfs.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "numa.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <exception>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sa {
+
+    namespace {
+
+        /// Parses a sysfs list such as "0-3,8,10-11".
+        std::vector<int> parse_list( const std::string & text )
+        {
+            std::vector<int> items;
+            std::istringstream in( text );
+            std::string part;
+            while ( std::getline( in, part, ',' ) ) {
+                if ( part.empty() || part == "\n" ) {
+                    continue;
+                }
+                std::size_t dash = part.find( '-' );
+                int low = std::stoi( part.substr( 0, dash ) );
+                int high = dash == std::string::npos ? low : std::stoi( part.substr( dash + 1 ) );
+                for ( int i = low ; i <= high ; ++i ) {
+                    items.push_back( i );
+                }
+            }
+            return items;
+        }
+
+#if defined(__linux__)
+        /// Highest node number the masks passed to the kernel can hold.
+        const int max_nodes{ 1024 };
+
+        /// A node mask holding only `node`, as `mbind` and `set_mempolicy` take it.
+        struct node_mask_t {
+            unsigned long bits[ ( max_nodes + 8 * sizeof(unsigned long) - 1 ) / ( 8 * sizeof(unsigned long) ) ];
+
+            explicit node_mask_t( int node ) : bits()
+            {
+                if ( node >= 0 && node < max_nodes ) {
+                    bits[ node / ( 8 * sizeof(unsigned long) ) ] |= 1ul << ( node % ( 8 * sizeof(unsigned long) ) );
+                }
+            }
+        };
+#endif
+
+        /// The first line of a sysfs file, or an empty string.
+        std::string read_line( const std::string & path )
+        {
+            std::ifstream file( path );
+            std::string line;
+            std::getline( file, line );
+            return line;
+        }
+    }
+
+    std::vector<int> numa_nodes( void )
+    {
+        std::vector<int> nodes = parse_list( read_line( "/sys/devices/system/node/online" ) );
+        if ( nodes.empty() ) {
+            nodes.push_back( 0 );
+        }
+        return nodes;
+    }
+
+    int current_numa_node( void )
+    {
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu{0}, node{0};
+        if ( syscall( SYS_getcpu, &cpu, &node, nullptr ) == 0 ) {
+            return static_cast<int>( node );
+        }
+#endif
+        return 0;
+    }
+
+    std::vector<int> numa_node_cpus( int node )
+    {
+        return parse_list( read_line( "/sys/devices/system/node/node" + std::to_string( node ) + "/cpulist" ) );
+    }
+
+    bool pin_to_numa_node( int node )
+    {
+#if defined(__linux__)
+        std::vector<int> cpus = numa_node_cpus( node );
+        if ( cpus.empty() ) {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        for ( int cpu : cpus ) {
+            CPU_SET( cpu, &set );
+        }
+        return sched_setaffinity( 0, sizeof(set), &set ) == 0;
+#else
+        (void) node;
+        return false;
+#endif
+    }
+
+    bool pin_to_cpu( int cpu )
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        CPU_SET( cpu, &set );
+        return sched_setaffinity( 0, sizeof(set), &set ) == 0;
+#else
+        (void) cpu;
+        return false;
+#endif
+    }
+
+    bool bind_memory_to_numa_node( int node )
+    {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+        node_mask_t mask( node );
+        return syscall( SYS_set_mempolicy, MPOL_BIND, mask.bits, max_nodes + 1 ) == 0;
+#else
+        (void) node;
+        return false;
+#endif
+    }
+
+    int numa_node_of( const void * address )
+    {
+#if defined(__linux__) && defined(SYS_move_pages)
+        // With no target nodes, move_pages only reports where each page is.
+        long page = sysconf( _SC_PAGESIZE );
+        void * pages[1] = { reinterpret_cast<void*>( reinterpret_cast<std::uintptr_t>( address ) & ~static_cast<std::uintptr_t>( page - 1 ) ) };
+        int status[1] = { -1 };
+        if ( syscall( SYS_move_pages, 0, 1, pages, nullptr, status, 0 ) == 0 && status[0] >= 0 ) {
+            return status[0];
+        }
+#else
+        (void) address;
+#endif
+        return -1;
+    }
+
+    /*!
+     * Replicates `[first;last)` on every online node.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \throw std::bad_alloc if a replica cannot be allocated.
+     */
+    numa_replicas::numa_replicas( value_type * first, value_type * last )
+        : m_first{ first }, m_size{ static_cast<std::size_t>( last - first ) }, m_bound{ true }
+    {
+        const std::size_t bytes = std::max<std::size_t>( 1, m_size * sizeof(value_type) );
+
+        for ( int node : numa_nodes() ) {
+            replica_t r{ node, nullptr, bytes };
+#if defined(__linux__)
+            void * memory = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+            if ( memory == MAP_FAILED ) {
+                for ( const auto & done : m_replicas ) {
+                    munmap( done.data, done.bytes );
+                }
+                throw std::bad_alloc();
+            }
+            // Bind before the first touch, so the pages are allocated on `node` as the data is copied in.
+            node_mask_t mask( node );
+            if ( syscall( SYS_mbind, memory, bytes, MPOL_BIND, mask.bits, max_nodes + 1, MPOL_MF_MOVE ) != 0 ) {
+                m_bound = false;
+            }
+            r.data = static_cast<value_type*>( memory );
+#else
+            r.data = new value_type[ std::max<std::size_t>( 1, m_size ) ];
+            m_bound = false;
+#endif
+            std::copy( first, last, r.data );
+            m_replicas.push_back( r );
+        }
+    }
+
+    numa_replicas::~numa_replicas( void )
+    {
+        for ( const auto & r : m_replicas ) {
+#if defined(__linux__)
+            munmap( r.data, r.bytes );
+#else
+            delete [] r.data;
+#endif
+        }
+        m_replicas.clear();
+    }
+
+    /*!
+     * Returns the replica of `node`.
+     * \param node A NUMA node.
+     * \return The replica of `node`, or the first replica if `node` has none.
+     */
+    value_type * numa_replicas::replica( int node ) const
+    {
+        for ( const auto & r : m_replicas ) {
+            if ( r.node == node ) {
+                return r.data;
+            }
+        }
+        return m_replicas.front().data;
+    }
+
+    /*!
+     * Performs a **binary search** for `value` on the replica local to the calling thread.
+     * \param value The value we are looking for.
+     * \return A pointer to the location of `value` in the original range, or its `last` if no such element is found.
+     */
+    value_type * numa_replicas::bsearch( value_type value ) const
+    {
+        value_type * data = local();
+        return m_first + ( sa::bsearch( data, data + m_size, value ) - data );
+    }
+
+    /*!
+     * Lower bound of `value` on the replica local to the calling thread.
+     * \param value The value we are looking for.
+     * \return A pointer into the original range.
+     */
+    value_type * numa_replicas::lbound( value_type value ) const
+    {
+        value_type * data = local();
+        return m_first + ( sa::lbound( data, data + m_size, value ) - data );
+    }
+
+    /*!
+     * Upper bound of `value` on the replica local to the calling thread.
+     * \param value The value we are looking for.
+     * \return A pointer into the original range.
+     */
+    value_type * numa_replicas::ubound( value_type value ) const
+    {
+        value_type * data = local();
+        return m_first + ( sa::ubound( data, data + m_size, value ) - data );
+    }
+
+    /*!
+     * Maps a result obtained on a replica back to the original range.
+     * \param p A pointer into, or just past, one of the replicas.
+     * \return The pointer at the same position in the original range.
+     * \throw std::invalid_argument if `p` points into no replica.
+     */
+    value_type * numa_replicas::original( const value_type * p ) const
+    {
+        for ( const auto & r : m_replicas ) {
+            if ( p >= r.data && p <= r.data + m_size ) {
+                return m_first + ( p - r.data );
+            }
+        }
+        throw std::invalid_argument( "numa_replicas: pointer into no replica" );
+    }
+
+    /*!
+     * Runs a task per replica, each on a thread pinned to the replica's node, with its memory
+     * policy bound to that node, so whatever the task allocates and first touches is local there.
+     * \param task Called as `task( r, node, first, last )` for every replica `r`.
+     */
+    void numa_replicas::for_each_node( const std::function<void( std::size_t, int, value_type *, value_type * )> & task ) const
+    {
+        std::vector<std::exception_ptr> errors( m_replicas.size() );
+        std::vector<std::thread> workers;
+        for ( std::size_t r{0} ; r < m_replicas.size() ; ++r ) {
+            workers.push_back( std::thread( [this, &task, &errors, r]() {
+                try {
+                    const replica_t & replica = m_replicas[r];
+                    pin_to_numa_node( replica.node );
+                    bind_memory_to_numa_node( replica.node );
+                    task( r, replica.node, replica.data, replica.data + m_size );
+                }
+                catch ( ... ) {
+                    errors[r] = std::current_exception();
+                }
+            } ) );
+        }
+        for ( auto & t : workers ) {
+            t.join();
+        }
+        for ( const auto & e : errors ) {
+            if ( e ) {
+                std::rethrow_exception( e );
+            }
+        }
+    }
+}
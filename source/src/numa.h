@@ -0,0 +1,166 @@
+/*!
+ * \file numa.h
+ * NUMA-aware replication of read-only sorted arrays, and thread pinning helpers.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /// The NUMA nodes that are online (just `{0}` on non-NUMA machines).
+    std::vector<int> numa_nodes( void );
+
+    /// The NUMA node of the CPU the calling thread runs on.
+    int current_numa_node( void );
+
+    /// The CPUs of `node`.
+    std::vector<int> numa_node_cpus( int node );
+
+    /// Pins the calling thread to the CPUs of `node`; returns `false` if that is not possible.
+    bool pin_to_numa_node( int node );
+
+    /// Pins the calling thread to `cpu`; returns `false` if that is not possible.
+    bool pin_to_cpu( int cpu );
+
+    /// Binds the memory the calling thread allocates from now on to `node`; returns `false` if that is not possible.
+    bool bind_memory_to_numa_node( int node );
+
+    /// The NUMA node the page holding `address` lives on, or -1 if unknown.
+    int numa_node_of( const void * address );
+
+    /*!
+     * One copy of a read-only range per NUMA node.
+     *
+     * Each replica is mapped separately and bound to its node with `mbind` before the data is
+     * copied in, so all of its pages are local to that node. The search functions route each
+     * query to the replica of the node the calling thread is running on; pin the search workers
+     * with `pin_to_numa_node()` so they stay there.
+     *
+     * Results are pointers into the **original** range, as with `sa::bsearch`, whichever replica
+     * answered. On systems without NUMA support there is a single (unbound) replica.
+     *
+     * Only the array itself is replicated here; an auxiliary index can be kept per node as well
+     * with `numa_indexes`, which builds one over each replica with `for_each_node()`.
+     *
+     * \note The original range must outlive the replicas, since results point into it.
+     */
+    class numa_replicas {
+        public:
+            /// Replicates `[first,last)` on every online node.
+            numa_replicas( value_type * first, value_type * last );
+            ~numa_replicas( void );
+
+            numa_replicas( const numa_replicas & ) = delete;
+            numa_replicas & operator=( const numa_replicas & ) = delete;
+
+            /// The replica of `node`, or the first replica if `node` has none.
+            value_type * replica( int node ) const;
+
+            /// The replica local to the calling thread.
+            value_type * local( void ) const { return replica( current_numa_node() ); }
+
+            /// Number of replicas.
+            std::size_t n_replicas( void ) const { return m_replicas.size(); }
+
+            /// Number of elements in each replica.
+            std::size_t size( void ) const { return m_size; }
+
+            /// Whether the replicas were actually bound to their nodes.
+            bool bound( void ) const { return m_bound; }
+
+            /// `sa::bsearch` on the local replica; returns a pointer into the original range.
+            value_type * bsearch( value_type value ) const;
+
+            /// `sa::lbound` on the local replica; returns a pointer into the original range.
+            value_type * lbound( value_type value ) const;
+
+            /// `sa::ubound` on the local replica; returns a pointer into the original range.
+            value_type * ubound( value_type value ) const;
+
+            /// The position in the original range of `p`, a pointer into (or just past) any replica.
+            value_type * original( const value_type * p ) const;
+
+            /*!
+             * Runs `task( r, node, first, last )` for every replica `r`, over its range `[first,last)`,
+             * each on its own thread pinned to the replica's node, with the memory it allocates bound
+             * there (as far as the system allows); returns once all of them are done. The tasks run
+             * concurrently.
+             * \throw The first exception thrown by a task, once every task has finished.
+             */
+            void for_each_node( const std::function<void( std::size_t, int, value_type *, value_type * )> & task ) const;
+
+        private:
+            /// A replica and the node it lives on.
+            struct replica_t {
+                int node;            //!< The node.
+                value_type * data;   //!< The copy.
+                std::size_t bytes;   //!< Size of the mapping.
+            };
+
+            value_type * m_first;              //!< The original range.
+            std::size_t m_size;                //!< Number of elements.
+            std::vector<replica_t> m_replicas; //!< One per node.
+            bool m_bound;                      //!< Whether `mbind` succeeded for every replica.
+    };
+
+    /*!
+     * One auxiliary index per NUMA node, each built over that node's replica by a thread pinned
+     * there, so the index's own memory (first touched while it is built) is local to the node too.
+     *
+     * `Index` is any structure built over a range `[first,last)`, such as `sa::veb_index` or
+     * `sa::weighted_index`; its results point into the replica it was built over, and
+     * `numa_replicas::original()` maps them back to the original range.
+     *
+     * \note The replicas must outlive the indexes.
+     */
+    template < typename Index >
+    class numa_indexes {
+        public:
+            /*!
+             * Builds `make( first, last )` over every replica of `replicas`; `make` returns a
+             * `std::unique_ptr<Index>`, and is called from several threads at once.
+             */
+            template < typename Factory >
+            numa_indexes( const numa_replicas & replicas, Factory make )
+                : m_nodes( replicas.n_replicas() ), m_indexes( replicas.n_replicas() )
+            {
+                replicas.for_each_node( [&]( std::size_t r, int node, value_type * first, value_type * last ) {
+                    m_nodes[r] = node;
+                    m_indexes[r] = make( first, last );
+                } );
+            }
+
+            /// The index of `node`, or the first one if `node` has none.
+            Index & on( int node ) const
+            {
+                for ( std::size_t r{0} ; r < m_nodes.size() ; ++r ) {
+                    if ( m_nodes[r] == node ) {
+                        return *m_indexes[r];
+                    }
+                }
+                return *m_indexes.front();
+            }
+
+            /// The index local to the calling thread.
+            Index & local( void ) const { return on( current_numa_node() ); }
+
+            /// Number of indexes.
+            std::size_t n_indexes( void ) const { return m_indexes.size(); }
+
+        private:
+            std::vector<int> m_nodes;                      //!< Node of each index.
+            std::vector< std::unique_ptr<Index> > m_indexes; //!< One per replica.
+    };
+}
+
+#endif // NUMA_H
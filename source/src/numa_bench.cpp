@@ -0,0 +1,69 @@
+/*!
+ * This is the NUMA benchmark mode: it measures the latency of `sa::lbound` from threads pinned
+ * to each node, over replicas placed on each node, and prints a (thread node x data node) table.
+ * The diagonal is local access; everything else is remote.
+ * @date October 19th, 2026.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "searching.h"
+#include "numa.h"
+
+int main( int argc, char * argv[] )
+{
+    // Default: 64M keys (256 MiB), well past the LLC, so probes go to memory.
+    std::size_t size = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : std::size_t{1} << 26;
+    std::size_t n_queries = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 1000000;
+
+    std::vector<sa::value_type> data( size );
+    for ( std::size_t i{0} ; i < size ; ++i ) {
+        data[i] = static_cast<sa::value_type>( 2 * i );
+    }
+    sa::numa_replicas replicas{ data.data(), data.data() + data.size() };
+    std::vector<int> nodes = sa::numa_nodes();
+
+    std::cout << "keys: " << size << ", queries: " << n_queries << ", replicas: " << replicas.n_replicas()
+              << ( replicas.bound() ? " (bound)" : " (not bound)" ) << "\n";
+    std::cout << "ns/query, rows = thread node, columns = data node\n" << std::setw(8) << " ";
+    for ( int d : nodes ) {
+        std::cout << std::setw(10) << d;
+    }
+    std::cout << "\n";
+
+    for ( int t : nodes ) {
+        std::cout << std::setw(8) << t;
+        for ( int d : nodes ) {
+            double ns{0};
+            // A fresh thread per cell, so the pinning does not leak into the next measurement.
+            std::thread worker( [&]() {
+                sa::pin_to_numa_node( t );
+                sa::value_type * first = replicas.replica( d );
+                sa::value_type * last = first + replicas.size();
+                std::mt19937 rng{ 42 };
+                std::uniform_int_distribution<sa::value_type> pick( 0, static_cast<sa::value_type>( 2 * size ) );
+
+                // Dependent chain: each key depends on the previous result, so latencies do not overlap.
+                std::size_t carry{0};
+                auto start = std::chrono::steady_clock::now();
+                for ( std::size_t q{0} ; q < n_queries ; ++q ) {
+                    sa::value_type key = pick( rng ) ^ static_cast<sa::value_type>( carry & 1 );
+                    carry = static_cast<std::size_t>( sa::lbound( first, last, key ) - first );
+                }
+                auto end = std::chrono::steady_clock::now();
+                ns = std::chrono::duration<double, std::nano>( end - start ).count() / static_cast<double>( n_queries );
+            } );
+            worker.join();
+            std::cout << std::setw(10) << std::fixed << std::setprecision(1) << ns;
+        }
+        std::cout << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
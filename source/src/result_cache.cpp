@@ -0,0 +1,217 @@
+/*!
+ * \file result_cache.cpp
+ * Implementation of the set-associative search result cache.
+ * \date October 19th, 2026.
+ */
+
+#include "result_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace sa {
+
+    const std::size_t result_cache::ways;
+    const std::size_t result_cache::set_words;
+
+    namespace {
+
+        /// Marks an unused entry.
+        const std::int32_t invalid{ -1 };
+
+        /// Mixes the bits of `key` (the 32-bit finalizer from MurmurHash3).
+        inline std::uint32_t mix( value_type key )
+        {
+            std::uint32_t h = static_cast<std::uint32_t>( key );
+            h ^= h >> 16;
+            h *= 0x85EBCA6Bu;
+            h ^= h >> 13;
+            h *= 0xC2B2AE35u;
+            h ^= h >> 16;
+            return h;
+        }
+
+        /// Shared by the cached searches: looks `value` up, or runs `search` and remembers its result.
+        value_type * cached( result_cache & cache, value_type * first, value_type * last, value_type value,
+                value_type * (*search)( value_type *, value_type *, value_type ) )
+        {
+            std::ptrdiff_t index;
+            if ( cache.lookup( value, index ) ) {
+                return first + index;
+            }
+            value_type* result = search( first, last, value );
+            cache.insert( value, result - first );
+            return result;
+        }
+    }
+
+    result_cache::result_cache( std::size_t capacity )
+        : m_sets{ nullptr }, m_n_sets{ 1 }
+    {
+        while ( m_n_sets * ways < capacity ) {
+            m_n_sets *= 2;
+        }
+
+        allocate();
+        m_clock.assign( m_n_sets, 0 );
+
+        m_stats.hits = m_stats.misses = 0;
+    }
+
+    result_cache::result_cache( const result_cache & other )
+        : m_sets{ nullptr }, m_clock{ other.m_clock }, m_n_sets{ other.m_n_sets }, m_stats( other.m_stats )
+    {
+        // `m_sets` points into the storage, so the copy needs its own, aligned on its own.
+        allocate();
+        std::copy( other.m_sets, other.m_sets + m_n_sets * set_words, m_sets );
+    }
+
+    result_cache::result_cache( result_cache && other )
+        : m_storage{ std::move( other.m_storage ) }, m_sets{ other.m_sets }, m_clock{ std::move( other.m_clock ) },
+          m_n_sets{ other.m_n_sets }, m_stats( other.m_stats )
+    {
+        other.m_sets = nullptr;
+        other.m_n_sets = 0;
+    }
+
+    result_cache & result_cache::operator=( result_cache other )
+    {
+        // Swapping the vectors swaps their buffers, so each `m_sets` still points into its own.
+        std::swap( m_storage, other.m_storage );
+        std::swap( m_sets, other.m_sets );
+        std::swap( m_clock, other.m_clock );
+        std::swap( m_n_sets, other.m_n_sets );
+        std::swap( m_stats, other.m_stats );
+        return *this;
+    }
+
+    void result_cache::allocate( void )
+    {
+        const std::size_t line_words = 64 / sizeof(std::int32_t);
+        m_storage.assign( m_n_sets * set_words + line_words, invalid );
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>( m_storage.data() );
+        std::size_t offset = ( 64 - address % 64 ) % 64;
+        m_sets = m_storage.data() + offset / sizeof(std::int32_t);
+    }
+
+    std::int32_t * result_cache::set_of( value_type key, std::size_t & set ) const
+    {
+        set = mix( key ) & ( m_n_sets - 1 );
+        return m_sets + set * set_words;
+    }
+
+    /*!
+     * Looks `key` up in the cache.
+     * \param key The searched value.
+     * \param index Receives the cached result (an offset from the beginning of the range) on a hit.
+     * \return `true` on a hit, `false` on a miss.
+     */
+    bool result_cache::lookup( value_type key, std::ptrdiff_t & index )
+    {
+        std::size_t set;
+        const std::int32_t * entries = set_of( key, set );
+
+        for ( std::size_t w{0} ; w < ways ; ++w ) {
+            if ( entries[w] == key && entries[ways + w] != invalid ) {
+                index = entries[ways + w];
+                m_clock[set] |= static_cast<std::uint16_t>( 1u << w );
+                ++m_stats.hits;
+                return true;
+            }
+        }
+
+        ++m_stats.misses;
+        return false;
+    }
+
+    /*!
+     * Remembers `index` as the result for `key`.
+     * Offsets that do not fit in 31 bits are not cached.
+     * \param key The searched value.
+     * \param index The search result, as an offset from the beginning of the range.
+     */
+    void result_cache::insert( value_type key, std::ptrdiff_t index )
+    {
+        if ( index < 0 || index > 0x7FFFFFFF ) {
+            return;
+        }
+
+        std::size_t set;
+        std::int32_t * entries = set_of( key, set );
+        std::uint16_t & clock = m_clock[set];
+
+        // Reuse the entry for `key`, or a free one.
+        std::size_t victim{ways};
+        for ( std::size_t w{0} ; w < ways ; ++w ) {
+            if ( entries[ways + w] != invalid && entries[w] == key ) {
+                victim = w;
+                break;
+            }
+            if ( victim == ways && entries[ways + w] == invalid ) {
+                victim = w;
+            }
+        }
+
+        // Otherwise, CLOCK: sweep the hand, clearing reference bits, until an unreferenced entry is found.
+        if ( victim == ways ) {
+            std::size_t hand = clock >> 8;
+            while ( clock & ( 1u << hand ) ) {
+                clock &= static_cast<std::uint16_t>( ~( 1u << hand ) );
+                hand = ( hand + 1 ) % ways;
+            }
+            victim = hand;
+            clock = static_cast<std::uint16_t>( ( clock & 0xFF ) | ( ( ( hand + 1 ) % ways ) << 8 ) );
+        }
+
+        entries[victim] = key;
+        entries[ways + victim] = static_cast<std::int32_t>( index );
+    }
+
+    void result_cache::clear( void )
+    {
+        std::fill( m_sets, m_sets + m_n_sets * set_words, invalid );
+        std::fill( m_clock.begin(), m_clock.end(), 0 );
+    }
+
+    /*!
+     * Returns a pointer to the first element in the range `[first, last)` that is _not less_  than (i.e. greater or equal to) `value`, or `last` if no such element is found.
+     * Answers from `cache` when `value` has been looked up before.
+     * \note The range **must** be sorted, and `cache` must only be used for lower bounds on this range.
+     * \param cache The result cache.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * lbound( result_cache & cache, value_type * first, value_type * last, value_type value )
+    {
+        return cached( cache, first, last, value, lbound );
+    }
+
+    /*!
+     * Returns a pointer to the first element in the range `[first, last)` that is _greater_  than `value`, or `last` if no such element is found.
+     * Answers from `cache` when `value` has been looked up before.
+     * \note The range **must** be sorted, and `cache` must only be used for upper bounds on this range.
+     * \param cache The result cache.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * ubound( result_cache & cache, value_type * first, value_type * last, value_type value )
+    {
+        return cached( cache, first, last, value, ubound );
+    }
+
+    /*!
+     * Performs a **binary search** for `value` in `[first;last)` and returns a pointer to the location of `value` in the range `[first,last]`, or `last` if no such element is found.
+     * Answers from `cache` when `value` has been looked up before.
+     * \note The range **must** be sorted, and `cache` must only be used for binary searches on this range.
+     * \param cache The result cache.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * bsearch( result_cache & cache, value_type * first, value_type * last, value_type value )
+    {
+        return cached( cache, first, last, value, bsearch );
+    }
+}
@@ -0,0 +1,98 @@
+/*!
+ * \file result_cache.h
+ * A small set-associative cache of search results, for workloads where a few keys are queried most of the time.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * Fixed-size cache mapping a searched value to the index the search returned.
+     *
+     * The cache is 8-way set-associative: each set holds 8 keys and 8 indices packed in exactly
+     * one 64-byte cache line, so a lookup touches a single line. Within a set, entries are
+     * replaced with the CLOCK (second chance) policy.
+     *
+     * \note A cache is **not** thread-safe; give each thread its own instance (e.g. `thread_local`,
+     *       or a copy of a configured cache: copies share nothing).
+     * \note A cache remembers results for one range and one search function only.
+     */
+    class result_cache {
+        public:
+            /// Hit and miss counters.
+            struct stats_t {
+                std::uint64_t hits;   //!< Lookups answered by the cache.
+                std::uint64_t misses; //!< Lookups that had to go to the search function.
+                /// Fraction of lookups answered by the cache.
+                double hit_ratio( void ) const
+                { return hits + misses == 0 ? 0.0 : static_cast<double>( hits ) / static_cast<double>( hits + misses ); }
+            };
+
+            /// Creates a cache with room for at least `capacity` entries (rounded up to a power of two, at least 8).
+            explicit result_cache( std::size_t capacity=4096 );
+
+            /// Copies the entries and counters into sets of its own, aligned afresh.
+            result_cache( const result_cache & other );
+            /// Takes over the sets of `other`, which is left empty.
+            result_cache( result_cache && other );
+            /// Copy or move assignment.
+            result_cache & operator=( result_cache other );
+
+            /// Looks `key` up; on a hit stores the cached result in `index` and returns `true`.
+            bool lookup( value_type key, std::ptrdiff_t & index );
+
+            /// Stores `index` as the result for `key`, evicting an entry of its set if needed.
+            void insert( value_type key, std::ptrdiff_t index );
+
+            /// Forgets every entry (counters are kept).
+            void clear( void );
+
+            /// Number of entries the cache may hold.
+            std::size_t capacity( void ) const { return m_n_sets * ways; }
+
+            /// The hit and miss counters.
+            const stats_t & stats( void ) const { return m_stats; }
+
+            /// Zeroes the hit and miss counters.
+            void reset_stats( void ) { m_stats.hits = m_stats.misses = 0; }
+
+        private:
+            /// Entries per set.
+            static const std::size_t ways = 8;
+            /// Words per set: `ways` keys followed by `ways` indices.
+            static const std::size_t set_words = 2 * ways;
+
+            /// Allocates `m_n_sets` empty sets and points `m_sets` at the first one.
+            void allocate( void );
+
+            std::vector<std::int32_t> m_storage; //!< Backing storage, with room to align the sets.
+            std::int32_t * m_sets;               //!< First set, aligned to a cache line.
+            std::vector<std::uint16_t> m_clock;  //!< Per set: reference bits (low byte) and clock hand (high byte).
+            std::size_t m_n_sets;                //!< Number of sets (a power of two).
+            stats_t m_stats;                     //!< Counters.
+
+            /// The set `key` maps to.
+            std::int32_t * set_of( value_type key, std::size_t & set ) const;
+    };
+
+    /// Lower bound that answers from `cache` when it can, and remembers the results it computes.
+    value_type * lbound( result_cache & cache, value_type * first, value_type * last, value_type value );
+
+    /// Upper bound that answers from `cache` when it can, and remembers the results it computes.
+    value_type * ubound( result_cache & cache, value_type * first, value_type * last, value_type value );
+
+    /// Binary search that answers from `cache` when it can, and remembers the results it computes.
+    value_type * bsearch( result_cache & cache, value_type * first, value_type * last, value_type value );
+}
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,494 @@
+/*!
+ * This is `sa_query`, a streaming query service over a sorted key file.
+ *
+ * The keys are loaded once (raw native `value_type`s, as written by `sa::disk_index::write()`, or
+ * whitespace-separated integers with `--text-keys`) and checked to be sorted. Queries are then read
+ * as whitespace-separated integers from stdin, or from every connection to a Unix domain socket,
+ * and one result per query is written back, one per line:
+ *
+ *  + `lbound`/`ubound`: the index of the bound (the number of keys if there is none);
+ *  + `bsearch`: the index of a key equal to the query, or -1.
+ *
+ * A query is an optional sign followed by decimal digits. Any other token, or one that does not
+ * fit in `value_type`, gets the line `error: malformed query` or `error: query out of range` in
+ * place of its result, and the stream goes on, so results stay in step with queries.
+ *
+ * Each stream runs a three-stage pipeline: a reader thread parses big chunks of input into batches
+ * of queries, a search thread answers each batch, and the calling thread formats the results into
+ * a large output buffer, flushed when full or when no more results are waiting. The stages hand
+ * whole batches to each other through small bounded queues, so synchronization is amortized over
+ * thousands of queries.
+ *
+ * Usage: sa_query KEYFILE [--text-keys] [--op lbound|ubound|bsearch] [--socket PATH] [--batch 4096]
+ * @date October 19th, 2026.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "searching.h"
+#include "sorting.h"
+
+namespace {
+
+    /// Bytes read from the input at a time.
+    const std::size_t read_bytes{ 1u << 20 };
+    /// Size of the output buffer.
+    const std::size_t write_bytes{ 1u << 20 };
+    /// Batches that may wait between two stages.
+    const std::size_t queue_depth{ 4 };
+
+    /// What the parser made of a token.
+    enum class token_t : std::uint8_t { VALID, MALFORMED, OUT_OF_RANGE };
+
+    /// A batch of queries, then of results; an empty batch ends the stream.
+    struct batch_t {
+        std::vector<sa::value_type> queries;
+        std::vector<token_t> tokens;   //!< Per query; the query of an invalid token is a placeholder.
+        std::vector<std::int64_t> results;
+    };
+
+    /// A bounded blocking queue of batches.
+    class batch_queue {
+        public:
+            void push( std::unique_ptr<batch_t> batch )
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_not_full.wait( lock, [this]() { return m_batches.size() < queue_depth; } );
+                m_batches.push( std::move( batch ) );
+                m_not_empty.notify_one();
+            }
+
+            std::unique_ptr<batch_t> pop( void )
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_not_empty.wait( lock, [this]() { return not m_batches.empty(); } );
+                std::unique_ptr<batch_t> batch = std::move( m_batches.front() );
+                m_batches.pop();
+                m_not_full.notify_one();
+                return batch;
+            }
+
+            bool empty( void )
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                return m_batches.empty();
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_not_full, m_not_empty;
+            std::queue< std::unique_ptr<batch_t> > m_batches;
+    };
+
+    /// Whether the 8 bytes of `chunk` are all ASCII digits.
+    inline bool eight_digits( std::uint64_t chunk )
+    {
+        return ( ( chunk & 0xF0F0F0F0F0F0F0F0ull ) | ( ( ( chunk + 0x0606060606060606ull ) & 0xF0F0F0F0F0F0F0F0ull ) >> 4 ) )
+               == 0x3333333333333333ull;
+    }
+
+    /// The value of 8 ASCII digits, converted all at once inside a 64-bit register (little endian).
+    inline std::uint32_t parse_eight( std::uint64_t chunk )
+    {
+        chunk -= 0x3030303030303030ull;
+        chunk = chunk * 10 + ( chunk >> 8 );
+        chunk = ( ( ( chunk & 0x000000FF000000FFull ) * ( 100 + ( 1000000ull << 32 ) ) )
+                + ( ( ( chunk >> 16 ) & 0x000000FF000000FFull ) * ( 1 + ( 10000ull << 32 ) ) ) ) >> 32;
+        return static_cast<std::uint32_t>( chunk );
+    }
+
+    /*!
+     * Incremental integer parser: tokens are separated by whitespace and may be split across two
+     * reads, so the state of the token being parsed is kept between calls. A valid token is an
+     * optional sign followed by digits, with a value that fits in `value_type`.
+     */
+    class parser {
+        public:
+            /*!
+             * Parses `[p,end)`, appending every complete token to `out`. If `tokens` is given, it
+             * receives what each token was, and invalid ones are appended to `out` as 0; otherwise
+             * an invalid token throws.
+             * \throw std::invalid_argument if a token is malformed (only without `tokens`).
+             * \throw std::out_of_range if a number does not fit in `value_type` (only without `tokens`).
+             */
+            void parse( const char * p, const char * end, std::vector<sa::value_type> & out, std::vector<token_t> * tokens = nullptr )
+            {
+                while ( p != end ) {
+                    const char c = *p;
+                    if ( c >= '0' && c <= '9' ) {
+                        // Eight digits at a time while they last, then one at a time.
+                        std::uint64_t chunk;
+                        if ( end - p >= 8 && ( std::memcpy( &chunk, p, 8 ), eight_digits( chunk ) ) ) {
+                            accumulate( 100000000, parse_eight( chunk ) );
+                            p += 8;
+                        }
+                        else {
+                            accumulate( 10, static_cast<std::uint32_t>( c - '0' ) );
+                            ++p;
+                        }
+                        m_digits = true;
+                        m_started = true;
+                        continue;
+                    }
+                    if ( c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f' ) {
+                        finish( out, tokens );
+                    }
+                    else if ( ( c == '-' || c == '+' ) && not m_started ) {
+                        m_negative = c == '-';
+                        m_started = true;
+                    }
+                    else {
+                        m_malformed = true;
+                        m_started = true;
+                    }
+                    ++p;
+                }
+            }
+
+            /// Ends the token in progress, if any (at a separator or the end of the stream).
+            void finish( std::vector<sa::value_type> & out, std::vector<token_t> * tokens = nullptr )
+            {
+                if ( m_started ) {
+                    const token_t token = m_malformed || not m_digits ? token_t::MALFORMED
+                                        : m_overflow ? token_t::OUT_OF_RANGE
+                                        : token_t::VALID;
+                    if ( token != token_t::VALID && tokens == nullptr ) {
+                        if ( token == token_t::MALFORMED ) {
+                            throw std::invalid_argument( "sa_query: malformed number" );
+                        }
+                        throw std::out_of_range( "sa_query: number out of range" );
+                    }
+                    const std::int64_t value = m_negative ? -static_cast<std::int64_t>( m_value ) : static_cast<std::int64_t>( m_value );
+                    out.push_back( token == token_t::VALID ? static_cast<sa::value_type>( value ) : 0 );
+                    if ( tokens != nullptr ) {
+                        tokens->push_back( token );
+                    }
+                }
+                m_value = 0;
+                m_digits = m_negative = m_started = m_malformed = m_overflow = false;
+            }
+
+        private:
+            std::uint64_t m_value{ 0 };
+            bool m_digits{ false };     //!< The token has digits.
+            bool m_negative{ false };   //!< It started with `-`.
+            bool m_started{ false };    //!< A token is in progress.
+            bool m_malformed{ false };  //!< It has a character that is neither a leading sign nor a digit.
+            bool m_overflow{ false };   //!< Its value does not fit.
+
+            /// Appends digits worth `digits` at `scale`, unless the value has already overflowed.
+            void accumulate( std::uint64_t scale, std::uint32_t digits )
+            {
+                if ( m_overflow ) {
+                    return;
+                }
+                m_value = m_value * scale + digits;
+                const std::uint64_t limit = m_negative ? static_cast<std::uint64_t>( std::numeric_limits<sa::value_type>::max() ) + 1
+                                                       : static_cast<std::uint64_t>( std::numeric_limits<sa::value_type>::max() );
+                m_overflow = m_value > limit;
+            }
+    };
+
+    /// Buffered writer of decimal integers, one per line.
+    class writer {
+        public:
+            explicit writer( int fd ) : m_fd{ fd }, m_buffer( write_bytes ), m_used{ 0 } {}
+
+            void put( const char * text )
+            {
+                const std::size_t n = std::strlen( text );
+                if ( m_used + n + 1 > m_buffer.size() ) {
+                    flush();
+                }
+                std::memcpy( m_buffer.data() + m_used, text, n );
+                m_used += n;
+                m_buffer[ m_used++ ] = '\n';
+            }
+
+            void put( std::int64_t value )
+            {
+                if ( m_used + 24 > m_buffer.size() ) {
+                    flush();
+                }
+                char digits[24];
+                int n{0};
+                std::uint64_t magnitude = value < 0 ? 0 - static_cast<std::uint64_t>( value ) : static_cast<std::uint64_t>( value );
+                do {
+                    digits[n++] = static_cast<char>( '0' + magnitude % 10 );
+                    magnitude /= 10;
+                } while ( magnitude != 0 );
+                if ( value < 0 ) {
+                    m_buffer[ m_used++ ] = '-';
+                }
+                while ( n > 0 ) {
+                    m_buffer[ m_used++ ] = digits[ --n ];
+                }
+                m_buffer[ m_used++ ] = '\n';
+            }
+
+            void flush( void )
+            {
+                std::size_t done{0};
+                while ( done < m_used ) {
+                    ssize_t n = ::write( m_fd, m_buffer.data() + done, m_used - done );
+                    if ( n < 0 && errno == EINTR ) {
+                        continue;
+                    }
+                    if ( n <= 0 ) {
+                        throw std::system_error( errno, std::generic_category(), "sa_query: write" );
+                    }
+                    done += static_cast<std::size_t>( n );
+                }
+                m_used = 0;
+            }
+
+        private:
+            int m_fd;
+            std::vector<char> m_buffer;
+            std::size_t m_used;
+    };
+
+    enum class op_t : int { LBOUND, UBOUND, BSEARCH };
+
+    /// Answers a batch; the loop has no dependencies between queries, so the core overlaps them.
+    void search( const std::vector<sa::value_type> & keys, op_t op, batch_t & batch )
+    {
+        sa::value_type * first = const_cast<sa::value_type*>( keys.data() );
+        sa::value_type * last = first + keys.size();
+        batch.results.resize( batch.queries.size() );
+        for ( std::size_t q{0} ; q < batch.queries.size() ; ++q ) {
+            const sa::value_type v = batch.queries[q];
+            sa::value_type * r = op == op_t::LBOUND ? sa::lbound( first, last, v )
+                               : op == op_t::UBOUND ? sa::ubound( first, last, v )
+                               : sa::bsearch( first, last, v );
+            batch.results[q] = ( op == op_t::BSEARCH && r == last ) ? -1 : static_cast<std::int64_t>( r - first );
+        }
+    }
+
+    /*!
+     * Runs the parse -> search -> write pipeline over one stream.
+     * \return `false` if the stream failed (an I/O error); the error is reported on stderr.
+     */
+    bool serve( const std::vector<sa::value_type> & keys, op_t op, std::size_t batch_size, int in_fd, int out_fd )
+    {
+        batch_queue parsed, answered;
+        std::string error;
+        std::mutex error_mutex;
+        auto fail = [&]( const std::string & what ) {
+            std::lock_guard<std::mutex> lock( error_mutex );
+            if ( error.empty() ) error = what;
+        };
+
+        // [1] Reader: read big chunks and parse them into batches.
+        std::thread reader( [&]() {
+            try {
+                std::vector<char> buffer( read_bytes );
+                parser p;
+                std::unique_ptr<batch_t> batch( new batch_t );
+                batch->queries.reserve( batch_size + read_bytes / 2 );
+                batch->tokens.reserve( batch_size + read_bytes / 2 );
+                for ( ;; ) {
+                    ssize_t n = ::read( in_fd, buffer.data(), buffer.size() );
+                    if ( n < 0 && errno == EINTR ) {
+                        continue;
+                    }
+                    if ( n < 0 ) {
+                        throw std::system_error( errno, std::generic_category(), "sa_query: read" );
+                    }
+                    if ( n == 0 ) {
+                        p.finish( batch->queries, &batch->tokens );
+                        break;
+                    }
+                    p.parse( buffer.data(), buffer.data() + n, batch->queries, &batch->tokens );
+                    // A short read means no more input is waiting: answer what we have, so
+                    // interactive clients are not kept waiting for a full batch.
+                    const bool drained = static_cast<std::size_t>( n ) < buffer.size();
+                    if ( batch->queries.size() >= batch_size || ( drained && not batch->queries.empty() ) ) {
+                        parsed.push( std::move( batch ) );
+                        batch.reset( new batch_t );
+                        batch->queries.reserve( batch_size + read_bytes / 2 );
+                        batch->tokens.reserve( batch_size + read_bytes / 2 );
+                    }
+                }
+                if ( not batch->queries.empty() ) {
+                    parsed.push( std::move( batch ) );
+                }
+            }
+            catch ( const std::exception & e ) {
+                fail( e.what() );
+            }
+            parsed.push( std::unique_ptr<batch_t>( new batch_t ) );
+        } );
+
+        // [2] Searcher.
+        std::thread searcher( [&]() {
+            for ( ;; ) {
+                std::unique_ptr<batch_t> batch = parsed.pop();
+                const bool last = batch->queries.empty();
+                if ( not last ) {
+                    search( keys, op, *batch );
+                }
+                answered.push( std::move( batch ) );
+                if ( last ) {
+                    break;
+                }
+            }
+        } );
+
+        // [3] Writer, on this thread: flush whenever no more results are waiting.
+        try {
+            writer out( out_fd );
+            for ( ;; ) {
+                std::unique_ptr<batch_t> batch = answered.pop();
+                if ( batch->queries.empty() ) {
+                    break;
+                }
+                for ( std::size_t q{0} ; q < batch->results.size() ; ++q ) {
+                    switch ( batch->tokens[q] ) {
+                        case token_t::VALID:        out.put( batch->results[q] ); break;
+                        case token_t::MALFORMED:    out.put( "error: malformed query" ); break;
+                        case token_t::OUT_OF_RANGE: out.put( "error: query out of range" ); break;
+                    }
+                }
+                if ( answered.empty() ) {
+                    out.flush();
+                }
+            }
+            out.flush();
+        }
+        catch ( const std::exception & e ) {
+            fail( e.what() );
+            // Keep draining, so the other stages can finish.
+            while ( not answered.pop()->queries.empty() ) {
+            }
+        }
+
+        reader.join();
+        searcher.join();
+        if ( not error.empty() ) {
+            std::cerr << error << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    /// Loads the keys: raw `value_type`s, or text with `text`.
+    std::vector<sa::value_type> load_keys( const std::string & path, bool text )
+    {
+        std::ifstream file( path, std::ios::binary );
+        if ( not file ) {
+            throw std::system_error( errno, std::generic_category(), "sa_query: cannot open " + path );
+        }
+        std::vector<char> bytes( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+        std::vector<sa::value_type> keys;
+        if ( text ) {
+            parser p;
+            p.parse( bytes.data(), bytes.data() + bytes.size(), keys );
+            p.finish( keys );
+        }
+        else {
+            if ( bytes.size() % sizeof(sa::value_type) != 0 ) {
+                throw std::invalid_argument( "sa_query: " + path + " is not a whole number of keys" );
+            }
+            keys.resize( bytes.size() / sizeof(sa::value_type) );
+            std::memcpy( keys.data(), bytes.data(), bytes.size() );
+        }
+        if ( not sa::is_sorted( keys.data(), keys.data() + keys.size() ) ) {
+            throw std::invalid_argument( "sa_query: the keys in " + path + " are not sorted" );
+        }
+        return keys;
+    }
+
+    /// Serves every connection to a Unix domain socket at `path`, one pipeline per connection.
+    void listen_on( const std::string & path, const std::vector<sa::value_type> & keys, op_t op, std::size_t batch_size )
+    {
+        // A client that hangs up must not kill the service.
+        ::signal( SIGPIPE, SIG_IGN );
+        int fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+        sockaddr_un address;
+        std::memset( &address, 0, sizeof(address) );
+        address.sun_family = AF_UNIX;
+        if ( path.size() >= sizeof(address.sun_path) ) {
+            throw std::invalid_argument( "sa_query: socket path too long" );
+        }
+        std::strcpy( address.sun_path, path.c_str() );
+        ::unlink( path.c_str() );
+        if ( fd < 0 || ::bind( fd, reinterpret_cast<sockaddr*>( &address ), sizeof(address) ) != 0 || ::listen( fd, 64 ) != 0 ) {
+            throw std::system_error( errno, std::generic_category(), "sa_query: cannot listen on " + path );
+        }
+        for ( ;; ) {
+            int connection = ::accept( fd, nullptr, nullptr );
+            if ( connection < 0 ) {
+                if ( errno == EINTR ) {
+                    continue;
+                }
+                throw std::system_error( errno, std::generic_category(), "sa_query: accept" );
+            }
+            // The keys are read-only and outlive every connection.
+            std::thread( [&keys, op, batch_size, connection]() {
+                serve( keys, op, batch_size, connection, connection );
+                ::close( connection );
+            } ).detach();
+        }
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    const char * usage = " KEYFILE [--text-keys] [--op lbound|ubound|bsearch] [--socket PATH] [--batch 4096]\n";
+    if ( argc < 2 ) {
+        std::cerr << "usage: " << argv[0] << usage;
+        return EXIT_FAILURE;
+    }
+    std::string key_path = argv[1], socket_path;
+    bool text_keys{false};
+    op_t op{ op_t::LBOUND };
+    std::size_t batch_size{ 4096 };
+    for ( int i{2} ; i < argc ; ++i ) {
+        std::string arg = argv[i];
+        if ( arg == "--text-keys" ) text_keys = true;
+        else if ( arg == "--op" && i + 1 < argc ) {
+            std::string name = argv[++i];
+            if ( name == "lbound" ) op = op_t::LBOUND;
+            else if ( name == "ubound" ) op = op_t::UBOUND;
+            else if ( name == "bsearch" ) op = op_t::BSEARCH;
+            else { std::cerr << "usage: " << argv[0] << usage; return EXIT_FAILURE; }
+        }
+        else if ( arg == "--socket" && i + 1 < argc ) socket_path = argv[++i];
+        else if ( arg == "--batch" && i + 1 < argc ) batch_size = std::max<std::size_t>( 1, std::strtoull( argv[++i], nullptr, 10 ) );
+        else { std::cerr << "usage: " << argv[0] << usage; return EXIT_FAILURE; }
+    }
+
+    try {
+        std::vector<sa::value_type> keys = load_keys( key_path, text_keys );
+        if ( not socket_path.empty() ) {
+            listen_on( socket_path, keys, op, batch_size );
+        }
+        return serve( keys, op, batch_size, STDIN_FILENO, STDOUT_FILENO ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch ( const std::exception & e ) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
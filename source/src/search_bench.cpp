@@ -0,0 +1,217 @@
+/*!
+ * This is the search benchmark: every algorithm in `searching.h`, in three modes, over array
+ * sizes from inside L1 to several times the last-level cache.
+ *
+ *  + `latency`: a dependent chain, each key derived from the previous result, so the queries
+ *    cannot overlap in the pipeline. This is the per-request latency with a warm cache.
+ *  + `throughput`: independent queries, which the CPU overlaps; the best case per query.
+ *  + `cold`: the array is evicted by sweeping a buffer larger than the LLC before every query,
+ *    and only the query is timed. This is the latency of a request that finds nothing cached.
+ *
+ * Output is tab separated: algorithm, mode, keys, bytes, ns/query (median of the repetitions).
+ *
+ * Usage: search_bench [--mode latency|throughput|cold|all] [--llc-multiple 4] [--llc BYTES]
+ *                     [--queries 100000] [--cold-queries 64] [--algorithm NAME]
+ * @date October 19th, 2026.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "searching.h"
+
+namespace {
+
+    /// An algorithm under test; `linear` ones get fewer queries on large arrays.
+    struct algorithm_t {
+        const char * name;
+        bool linear;
+        sa::value_type * (*search)( sa::value_type *, sa::value_type *, sa::value_type );
+    };
+
+    sa::value_type * lbound_mid( sa::value_type * first, sa::value_type * last, sa::value_type value )
+    {
+        return sa::lbound_hint( first, last, value, first + ( last - first ) / 2 );
+    }
+
+    sa::value_type * ubound_mid( sa::value_type * first, sa::value_type * last, sa::value_type value )
+    {
+        return sa::ubound_hint( first, last, value, first + ( last - first ) / 2 );
+    }
+
+    const algorithm_t algorithms[] = {
+        { "lsearch",     true,  sa::lsearch },
+        { "bsearch",     false, sa::bsearch },
+        { "bsearch_rec", false, sa::bsearch_rec_aux },
+        { "lbound",      false, sa::lbound },
+        { "ubound",      false, sa::ubound },
+        { "exp_bsearch", false, sa::exp_bsearch },
+        { "exp_lbound",  false, sa::exp_lbound },
+        { "exp_ubound",  false, sa::exp_ubound },
+        { "lbound_hint", false, lbound_mid },
+        { "ubound_hint", false, ubound_mid },
+    };
+
+    const int repetitions{ 5 };
+
+    /// Size in bytes of the last-level data cache, from sysfs (32 MiB if unknown).
+    std::size_t llc_bytes( void )
+    {
+        std::size_t best{0};
+        for ( int index{0} ; index < 8 ; ++index ) {
+            std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string( index ) + "/";
+            std::ifstream type_file( dir + "type" ), size_file( dir + "size" );
+            std::string type, size;
+            if ( not ( type_file >> type ) || not ( size_file >> size ) || type == "Instruction" ) {
+                continue;
+            }
+            std::size_t bytes = std::strtoull( size.c_str(), nullptr, 10 );
+            char unit = size.empty() ? ' ' : size.back();
+            bytes *= unit == 'K' ? 1024 : unit == 'M' ? 1024 * 1024 : 1;
+            best = std::max( best, bytes );
+        }
+        return best ? best : std::size_t{32} << 20;
+    }
+
+    double median( std::vector<double> v )
+    {
+        std::sort( v.begin(), v.end() );
+        return v[ v.size() / 2 ];
+    }
+
+    double elapsed_ns( std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end )
+    {
+        return std::chrono::duration<double, std::nano>( end - start ).count();
+    }
+
+    /// Dependent chain: each key depends on the previous result, so latencies do not overlap.
+    double latency( const algorithm_t & a, sa::value_type * first, sa::value_type * last, const std::vector<sa::value_type> & keys )
+    {
+        std::size_t carry{0};
+        auto start = std::chrono::steady_clock::now();
+        for ( sa::value_type key : keys ) {
+            carry = static_cast<std::size_t>( a.search( first, last, key ^ static_cast<sa::value_type>( carry & 1 ) ) - first );
+        }
+        auto end = std::chrono::steady_clock::now();
+        volatile std::size_t keep = carry;
+        (void) keep;
+        return elapsed_ns( start, end ) / static_cast<double>( keys.size() );
+    }
+
+    /// Independent queries: the CPU may run several of them at once.
+    double throughput( const algorithm_t & a, sa::value_type * first, sa::value_type * last, const std::vector<sa::value_type> & keys )
+    {
+        std::size_t sum{0};
+        auto start = std::chrono::steady_clock::now();
+        for ( sa::value_type key : keys ) {
+            sum += static_cast<std::size_t>( a.search( first, last, key ) - first );
+        }
+        auto end = std::chrono::steady_clock::now();
+        volatile std::size_t keep = sum;
+        (void) keep;
+        return elapsed_ns( start, end ) / static_cast<double>( keys.size() );
+    }
+
+    /// Every query runs after a sweep of `sweep` has pushed the array out of the caches.
+    double cold( const algorithm_t & a, sa::value_type * first, sa::value_type * last, const std::vector<sa::value_type> & keys,
+                 std::vector<char> & sweep )
+    {
+        double total{0};
+        std::size_t sum{0};
+        for ( sa::value_type key : keys ) {
+            for ( std::size_t i{0} ; i < sweep.size() ; i += 64 ) {
+                sweep[i] += 1;
+            }
+            auto start = std::chrono::steady_clock::now();
+            sum += static_cast<std::size_t>( a.search( first, last, key ) - first );
+            auto end = std::chrono::steady_clock::now();
+            total += elapsed_ns( start, end );
+        }
+        volatile std::size_t keep = sum;
+        (void) keep;
+        return total / static_cast<double>( keys.size() );
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    std::string mode{ "all" }, only;
+    double llc_multiple{ 4 };
+    std::size_t llc = llc_bytes();
+    std::size_t n_queries{ 100000 }, n_cold{ 64 };
+    bool usage_error{false};
+    for ( int i{1} ; i < argc ; ++i ) {
+        std::string arg = argv[i];
+        if ( i + 1 >= argc ) usage_error = true;
+        else if ( arg == "--mode" ) mode = argv[++i];
+        else if ( arg == "--llc-multiple" ) llc_multiple = std::atof( argv[++i] );
+        else if ( arg == "--llc" ) llc = std::strtoull( argv[++i], nullptr, 10 );
+        else if ( arg == "--queries" ) n_queries = std::strtoull( argv[++i], nullptr, 10 );
+        else if ( arg == "--cold-queries" ) n_cold = std::strtoull( argv[++i], nullptr, 10 );
+        else if ( arg == "--algorithm" ) only = argv[++i];
+        else usage_error = true;
+    }
+    if ( usage_error || ( mode != "latency" && mode != "throughput" && mode != "cold" && mode != "all" ) || n_queries == 0 || n_cold == 0 ) {
+        std::cerr << "usage: " << argv[0] << " [--mode latency|throughput|cold|all] [--llc-multiple 4] [--llc BYTES]"
+                  << " [--queries 100000] [--cold-queries 64] [--algorithm NAME]\n";
+        return EXIT_FAILURE;
+    }
+
+    // Sizes grow 4x at a time, from 4 KiB (inside L1) to `llc_multiple` times the LLC.
+    const std::size_t max_bytes = static_cast<std::size_t>( llc_multiple * static_cast<double>( llc ) );
+    std::vector<std::size_t> sizes;
+    for ( std::size_t bytes{4096} ; bytes <= max_bytes ; bytes *= 4 ) {
+        sizes.push_back( bytes / sizeof(sa::value_type) );
+    }
+    std::vector<char> sweep;
+    if ( mode == "cold" || mode == "all" ) {
+        sweep.assign( 2 * llc, 0 );
+    }
+
+    std::cout << "# LLC: " << llc << " bytes\n";
+    std::cout << "algorithm\tmode\tkeys\tbytes\tns/query\n";
+    std::mt19937 rng{ 42 };
+    for ( std::size_t n : sizes ) {
+        std::vector<sa::value_type> data( n );
+        for ( std::size_t i{0} ; i < n ; ++i ) {
+            data[i] = static_cast<sa::value_type>( 2 * i );
+        }
+        sa::value_type * first = data.data();
+        sa::value_type * last = first + n;
+        std::uniform_int_distribution<sa::value_type> pick( 0, static_cast<sa::value_type>( 2 * n ) );
+
+        for ( const auto & a : algorithms ) {
+            if ( not only.empty() && only != a.name ) {
+                continue;
+            }
+            // Keep linear searches over large arrays to a bounded amount of work.
+            std::size_t count = a.linear ? std::max<std::size_t>( 8, std::min( n_queries, ( std::size_t{1} << 26 ) / n ) ) : n_queries;
+            std::vector<sa::value_type> keys( count ), cold_keys( std::min( count, n_cold ) );
+            for ( auto & k : keys ) k = pick( rng );
+            for ( auto & k : cold_keys ) k = pick( rng );
+
+            struct { const char * name; int id; } modes[] = { { "latency", 0 }, { "throughput", 1 }, { "cold", 2 } };
+            for ( const auto & m : modes ) {
+                if ( mode != "all" && mode != m.name ) {
+                    continue;
+                }
+                std::vector<double> runs;
+                for ( int r{0} ; r < repetitions ; ++r ) {
+                    runs.push_back( m.id == 0 ? latency( a, first, last, keys )
+                                  : m.id == 1 ? throughput( a, first, last, keys )
+                                  : cold( a, first, last, cold_keys, sweep ) );
+                }
+                std::cout << a.name << "\t" << m.name << "\t" << n << "\t" << n * sizeof(sa::value_type) << "\t" << median( runs ) << "\n";
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,337 @@
+/*!
+ * \file searcher.cpp
+ * Implementation of the adaptive search facade, together with the scan and probe kernels it ships.
+ * \date October 19th, 2026.
+ */
+
+#include "searcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sa {
+
+    constexpr std::size_t searcher::n_strategies;
+
+    namespace {
+
+        /// Sorted ranges larger than this are never handed to the O(n) kernels.
+        const std::size_t scan_limit{ 4096 };
+        /// Rough amount of element visits an O(n) kernel may spend during calibration.
+        const std::size_t scan_budget{ std::size_t{1} << 22 };
+        /// After this many interpolation steps the probe kernel falls back to binary search.
+        const int probe_max_steps{ 32 };
+
+        /*!
+         * Returns a pointer to the first element equal to `value` in the unsorted range `[first,last)`, or `last`.
+         * Compares four keys per step when SSE2 is available.
+         */
+        value_type * scan_eq( value_type * first, value_type * last, value_type value )
+        {
+            value_type* p{first};
+#if defined(__SSE2__)
+            static_assert( sizeof(value_type) == 4, "SSE2 scan assumes 32-bit keys" );
+            const __m128i key = _mm_set1_epi32( value );
+            for ( ; last - p >= 4 ; p += 4 ) {
+                __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+                int mask = _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( block, key ) ) );
+                if ( mask != 0 ) {
+                    return p + __builtin_ctz( mask );
+                }
+            }
+#endif
+            for ( ; p < last ; ++p ) {
+                if ( *p == value ) {
+                    return p;
+                }
+            }
+            return last;
+        }
+
+        /*!
+         * Branchless rank on the sorted range `[first,last)`: counts the elements less than `value`
+         * (which gives the lower bound), and checks the element found there.
+         */
+        value_type * scan_rank( value_type * first, value_type * last, value_type value )
+        {
+            std::ptrdiff_t count{0};
+            value_type* p{first};
+#if defined(__SSE2__)
+            const __m128i key = _mm_set1_epi32( value );
+            __m128i acc = _mm_setzero_si128();
+            for ( ; last - p >= 4 ; p += 4 ) {
+                __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+                // Each lane is -1 where block < key, so subtracting counts them.
+                acc = _mm_sub_epi32( acc, _mm_cmplt_epi32( block, key ) );
+            }
+            alignas(16) std::int32_t lanes[4];
+            _mm_store_si128( reinterpret_cast<__m128i*>( lanes ), acc );
+            count = static_cast<std::ptrdiff_t>( lanes[0] ) + lanes[1] + lanes[2] + lanes[3];
+#endif
+            for ( ; p < last ; ++p ) {
+                count += ( *p < value );
+            }
+            value_type* pos = first + count;
+            return ( pos != last && *pos == value ) ? pos : last;
+        }
+
+        /*!
+         * Interpolation search on the sorted range `[first,last)`: probes where `value` would be if
+         * the keys were evenly spaced. Falls back to `sa::bsearch` on skewed data.
+         */
+        value_type * probe( value_type * first, value_type * last, value_type value )
+        {
+            value_type* lo{first};
+            value_type* hi{last};
+
+            for ( int step{0} ; lo < hi ; ++step ) {
+                if ( value < *lo || value > *(hi-1) ) {
+                    return last;
+                }
+                if ( *lo == *(hi-1) ) {
+                    return lo;  // All remaining keys are equal, and equal to `value`.
+                }
+                if ( step == probe_max_steps ) {
+                    value_type* result = bsearch( lo, hi, value );
+                    return ( result == hi ) ? last : result;
+                }
+                double ratio = ( static_cast<double>( value ) - *lo ) / ( static_cast<double>( *(hi-1) ) - *lo );
+                value_type* middle = lo + static_cast<std::ptrdiff_t>( ratio * static_cast<double>( hi - 1 - lo ) );
+
+                if ( *middle == value ) {
+                    return middle;
+                }
+                else if ( *middle < value ) {
+                    lo = middle + 1;
+                }
+                else {
+                    hi = middle;
+                }
+            }
+
+            return last;
+        }
+
+        /// Maps `[0,1]` evenly spaced samples against the keys to measure how uniform the range is.
+        double measure_uniformity( const value_type * first, const value_type * last )
+        {
+            std::size_t n = static_cast<std::size_t>( last - first );
+            if ( n < 3 ) {
+                return 1.0;
+            }
+            double low = first[0];
+            double span = static_cast<double>( first[n-1] ) - low;
+            if ( span <= 0 ) {
+                return 0.0;
+            }
+
+            const std::size_t n_samples = std::min<std::size_t>( 64, n );
+            double deviation{0};
+            for ( std::size_t s{0} ; s < n_samples ; ++s ) {
+                std::size_t i = s * ( n - 1 ) / ( n_samples - 1 );
+                double expected = low + span * static_cast<double>( i ) / static_cast<double>( n - 1 );
+                deviation += std::fabs( first[i] - expected ) / span;
+            }
+            return std::max( 0.0, 1.0 - 2.0 * deviation / static_cast<double>( n_samples ) );
+        }
+    }
+
+    /*!
+     * Builds a searcher over `[first;last)`.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param calibration_queries Maximum number of queries used to time each candidate strategy.
+     */
+    searcher::searcher( value_type * first, value_type * last, std::size_t calibration_queries )
+        : m_first{ first }, m_last{ last }
+    {
+        m_profile.size = static_cast<std::size_t>( last - first );
+        m_profile.sorted = std::is_sorted( first, last );
+        m_profile.uniformity = m_profile.sorted ? measure_uniformity( first, last ) : 0.0;
+
+        calibrate( calibration_queries );
+    }
+
+    bool searcher::is_candidate( strategy_t strategy ) const
+    {
+        switch ( strategy ) {
+            case strategy_t::LINEAR:
+            case strategy_t::SCAN:
+                return m_profile.size <= scan_limit || not m_profile.sorted;
+            case strategy_t::BINARY:
+            case strategy_t::LBOUND:
+            case strategy_t::PROBE:
+                return m_profile.sorted;
+        }
+        return false;
+    }
+
+    void searcher::calibrate( std::size_t calibration_queries )
+    {
+        m_decision.latency_ns.fill( -1.0 );
+        m_decision.throughput_ns.fill( -1.0 );
+        m_decision.single = m_decision.batch = m_profile.sorted ? strategy_t::BINARY : strategy_t::LINEAR;
+
+        if ( m_profile.size == 0 ) {
+            return;
+        }
+
+        // O(n) kernels on large unsorted ranges get fewer queries, so calibration stays short.
+        std::size_t n_queries = std::max<std::size_t>( 1, calibration_queries );
+        if ( not m_profile.sorted ) {
+            n_queries = std::min( n_queries, std::max<std::size_t>( 4, scan_budget / m_profile.size ) );
+        }
+
+        // Half of the queries are hits, half are (most likely) misses.
+        std::mt19937 rng{ 0x5eed };
+        std::uniform_int_distribution<std::size_t> pick( 0, m_profile.size - 1 );
+        std::vector<value_type> queries( n_queries );
+        for ( std::size_t i{0} ; i < n_queries ; ++i ) {
+            value_type key = m_first[ pick( rng ) ];
+            queries[i] = ( i % 2 == 0 || key == std::numeric_limits<value_type>::max() ) ? key : key + 1;
+        }
+
+        using clock = std::chrono::steady_clock;
+        const int n_rounds{3};
+        double best_latency{-1}, best_throughput{-1};
+
+        for ( std::size_t s{0} ; s < n_strategies ; ++s ) {
+            strategy_t strategy = static_cast<strategy_t>( s );
+            if ( not is_candidate( strategy ) ) {
+                continue;
+            }
+
+            double latency{-1}, throughput{-1};
+            for ( int round{0} ; round < n_rounds ; ++round ) {
+                // Dependent chain: the next key depends on where the previous one was found.
+                std::size_t k{0};
+                auto start = clock::now();
+                for ( std::size_t i{0} ; i < n_queries ; ++i ) {
+                    value_type* result = find_with( strategy, queries[k] );
+                    k = ( k + 1 + static_cast<std::size_t>( result - m_first ) ) % n_queries;
+                }
+                double elapsed = std::chrono::duration<double, std::nano>( clock::now() - start ).count();
+                if ( latency < 0 || elapsed < latency ) {
+                    latency = elapsed;
+                }
+
+                // Independent batch.
+                std::ptrdiff_t sink{0};
+                start = clock::now();
+                for ( std::size_t i{0} ; i < n_queries ; ++i ) {
+                    sink += find_with( strategy, queries[i] ) - m_first;
+                }
+                elapsed = std::chrono::duration<double, std::nano>( clock::now() - start ).count();
+                if ( throughput < 0 || elapsed < throughput ) {
+                    throughput = elapsed;
+                }
+                // Keeps the batch loop from being optimized away.
+                volatile std::ptrdiff_t keep = sink;
+                (void) keep;
+            }
+
+            m_decision.latency_ns[s] = latency / static_cast<double>( n_queries );
+            m_decision.throughput_ns[s] = throughput / static_cast<double>( n_queries );
+
+            if ( best_latency < 0 || m_decision.latency_ns[s] < best_latency ) {
+                best_latency = m_decision.latency_ns[s];
+                m_decision.single = strategy;
+            }
+            if ( best_throughput < 0 || m_decision.throughput_ns[s] < best_throughput ) {
+                best_throughput = m_decision.throughput_ns[s];
+                m_decision.batch = strategy;
+            }
+        }
+    }
+
+    /*!
+     * Searches for `value` with the strategy chosen for single queries.
+     * \param value The value we are looking for.
+     * \return A pointer to an element equal to `value`, or `last` if no such element is found.
+     */
+    value_type * searcher::find( value_type value ) const
+    {
+        return find_with( m_decision.single, value );
+    }
+
+    /*!
+     * Searches every value in `[qfirst,qlast)` with the strategy chosen for batches.
+     * \param qfirst Pointer to the begining of the queries.
+     * \param qlast Pointer just past the last query.
+     * \param out Receives one result per query; must have room for `qlast - qfirst` pointers.
+     */
+    void searcher::find( const value_type * qfirst, const value_type * qlast, value_type ** out ) const
+    {
+        const strategy_t strategy = m_decision.batch;
+        while ( qfirst != qlast ) {
+            *out++ = find_with( strategy, *qfirst++ );
+        }
+    }
+
+    /*!
+     * Searches for `value` with `strategy`.
+     * \note Strategies that need a sorted range (`BINARY`, `LBOUND`, `PROBE`) return garbage on unsorted ones.
+     * \param strategy The strategy to use.
+     * \param value The value we are looking for.
+     */
+    value_type * searcher::find_with( strategy_t strategy, value_type value ) const
+    {
+        switch ( strategy ) {
+            case strategy_t::LINEAR:
+                return lsearch( m_first, m_last, value );
+            case strategy_t::BINARY:
+                return bsearch( m_first, m_last, value );
+            case strategy_t::LBOUND: {
+                value_type* result = lbound( m_first, m_last, value );
+                return ( result != m_last && *result == value ) ? result : m_last;
+            }
+            case strategy_t::SCAN:
+                return m_profile.sorted ? scan_rank( m_first, m_last, value ) : scan_eq( m_first, m_last, value );
+            case strategy_t::PROBE:
+                return probe( m_first, m_last, value );
+        }
+        return m_last;
+    }
+
+    std::string searcher::describe( void ) const
+    {
+        std::ostringstream oss;
+        oss << "size=" << m_profile.size
+            << " sorted=" << ( m_profile.sorted ? "yes" : "no" )
+            << " uniformity=" << m_profile.uniformity
+            << " single=" << to_string( m_decision.single )
+            << " batch=" << to_string( m_decision.batch )
+            << " [";
+        for ( std::size_t s{0} ; s < n_strategies ; ++s ) {
+            if ( m_decision.latency_ns[s] < 0 ) {
+                continue;
+            }
+            oss << " " << to_string( static_cast<strategy_t>( s ) )
+                << ":" << m_decision.latency_ns[s] << "/" << m_decision.throughput_ns[s] << "ns";
+        }
+        oss << " ]";
+        return oss.str();
+    }
+
+    const char * searcher::to_string( strategy_t strategy )
+    {
+        switch ( strategy ) {
+            case strategy_t::LINEAR: return "linear";
+            case strategy_t::BINARY: return "binary";
+            case strategy_t::LBOUND: return "lbound";
+            case strategy_t::SCAN:   return "scan";
+            case strategy_t::PROBE:  return "probe";
+        }
+        return "unknown";
+    }
+}
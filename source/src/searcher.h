@@ -0,0 +1,96 @@
+/*!
+ * \file searcher.h
+ * An adaptive search facade that picks, per array and per query profile, the
+ * fastest of the searching algorithms available in this library.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef SEARCHER_H
+#define SEARCHER_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * Adaptive search engine over a (non-owned) range of integers.
+     *
+     * At construction the range is profiled (size, sortedness and how uniform the
+     * distribution of keys is) and a short calibration is run on the current machine.
+     * Each candidate strategy is timed twice: as a chain of dependent queries (latency,
+     * used by `find()` for single queries) and as an independent batch (throughput,
+     * used by the batch `find()`). Queries are then dispatched to the fastest one.
+     *
+     * \note The range must outlive the searcher and must not be modified while in use.
+     */
+    class searcher {
+        public:
+            /// The strategies a searcher may dispatch to.
+            enum class strategy_t : int {
+                LINEAR = 0, //!< `sa::lsearch`.
+                BINARY,     //!< `sa::bsearch`.
+                LBOUND,     //!< `sa::lbound` followed by an equality check.
+                SCAN,       //!< Vectorized scan (equality scan if unsorted, branchless rank if sorted).
+                PROBE       //!< Interpolation probe, good for uniformly distributed keys.
+            };
+            /// Number of strategies in `strategy_t`.
+            static constexpr std::size_t n_strategies = 5;
+
+            /// What the searcher learned about the range at construction.
+            struct profile_t {
+                std::size_t size;  //!< Number of elements in the range.
+                bool sorted;       //!< Whether the range is sorted (non-decreasing).
+                double uniformity; //!< In `[0,1]`, how close the keys are to an evenly spaced sequence (sorted ranges only).
+            };
+
+            /// The outcome of the calibration, exposed so the caller may log it.
+            struct decision_t {
+                strategy_t single; //!< Strategy used for single queries.
+                strategy_t batch;  //!< Strategy used for batches of queries.
+                std::array<double, n_strategies> latency_ns;    //!< Measured ns/query in dependent chains; negative if not a candidate.
+                std::array<double, n_strategies> throughput_ns; //!< Measured ns/query in independent batches; negative if not a candidate.
+            };
+
+            /// Profiles `[first,last)` and calibrates with up to `calibration_queries` queries.
+            searcher( value_type * first, value_type * last, std::size_t calibration_queries=256 );
+
+            /// Returns a pointer to an element equal to `value`, or `last` if there is none.
+            value_type * find( value_type value ) const;
+
+            /// Searches every query in `[qfirst,qlast)`, storing each result (as in `find()`) in `out`.
+            void find( const value_type * qfirst, const value_type * qlast, value_type ** out ) const;
+
+            /// Runs `value` through a specific strategy, regardless of the calibration.
+            value_type * find_with( strategy_t strategy, value_type value ) const;
+
+            /// The profile of the range.
+            const profile_t & profile( void ) const { return m_profile; }
+
+            /// The strategies chosen by the calibration, and the timings they were based on.
+            const decision_t & decision( void ) const { return m_decision; }
+
+            /// A one-line human readable summary of the profile and the decision.
+            std::string describe( void ) const;
+
+            /// The name of a strategy.
+            static const char * to_string( strategy_t strategy );
+
+        private:
+            value_type * m_first;   //!< Beginning of the searched range.
+            value_type * m_last;    //!< Just past the end of the searched range.
+            profile_t m_profile;    //!< Range profile.
+            decision_t m_decision;  //!< Calibration outcome.
+
+            /// Whether `strategy` produces correct results for this range.
+            bool is_candidate( strategy_t strategy ) const;
+            /// Times the candidates and fills in `m_decision`.
+            void calibrate( std::size_t calibration_queries );
+    };
+}
+
+#endif // SEARCHER_H
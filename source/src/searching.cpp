@@ -7,6 +7,8 @@
 
 #include "searching.h"
 
+#include <cstddef>
+
 namespace sa {
 
     /*!
@@ -167,5 +169,126 @@ namespace sa {
         return find;
         return first; // STUB
     }
+
+    namespace {
+
+        /*!
+         * Gallops outward from `hint` looking for the partition point of `[first, last)`, i.e. the first
+         * element that is not _before_ `value`. An element is _before_ `value` if it is less than `value`
+         * (lower bound) or, when `upper` is set, less than or equal to `value` (upper bound).
+         * The steps double at each iteration (1, 2, 4, ...), so the bracket around the answer is found
+         * in O(log d) probes, where d is the distance from `hint` to the answer, and is then narrowed
+         * down with a regular binary search.
+         */
+        value_type * gallop( value_type * first, value_type * last, value_type value, value_type * hint, bool upper )
+        {
+            if (hint < first) {
+                hint = first;
+            }
+            else if (hint > last) {
+                hint = last;
+            }
+
+            std::ptrdiff_t step{1};
+
+            if (hint != last && (upper ? *hint <= value : *hint < value)) {
+                // The answer lies in (hint, last]: gallop to the right.
+                value_type* lo{hint + 1};
+
+                while (step < last - hint && (upper ? *(hint + step) <= value : *(hint + step) < value)) {
+                    lo = hint + step + 1;
+                    step *= 2;
+                }
+
+                value_type* hi = (step < last - hint) ? hint + step : last;
+                return upper ? ubound(lo, hi, value) : lbound(lo, hi, value);
+            }
+
+            // The answer lies in [first, hint]: gallop to the left.
+            value_type* hi{hint};
+
+            while (step <= hint - first && (upper ? *(hint - step) > value : *(hint - step) >= value)) {
+                hi = hint - step;
+                step *= 2;
+            }
+
+            value_type* lo = (step <= hint - first) ? hint - step + 1 : first;
+            return upper ? ubound(lo, hi, value) : lbound(lo, hi, value);
+        }
+    }
+
+    /*!
+     * Performs an **exponential search** for `value` in `[first;last)` and returns a pointer to the location of `value` in the range `[first,last]`, or `last` if no such element is found.
+     * Costs O(log d) comparisons, where d is the distance from `first` to `value`, which beats `bsearch` when hits are expected near the front.
+     * \note The range **must** be sorted.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * exp_bsearch( value_type * first, value_type * last, value_type value )
+    {
+        value_type* find = gallop(first, last, value, first, false);
+
+        if (find != last && *find == value) {
+            return find;
+        }
+
+        return last;
+    }
+
+    /*!
+     * Returns a pointer to the first element in the range `[first, last)` that is _not less_  than (i.e. greater or equal to) `value`, or `last` if no such element is found.
+     * Gallops from `first`, costing O(log d) comparisons, where d is the distance from `first` to the answer.
+     * \note The range **must** be sorted.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * exp_lbound( value_type * first, value_type * last, value_type value )
+    {
+        return gallop(first, last, value, first, false);
+    }
+
+    /*!
+     * Returns a pointer to the first element in the range `[first, last)` that is _greater_  than `value`, or `last` if no such element is found.
+     * Gallops from `first`, costing O(log d) comparisons, where d is the distance from `first` to the answer.
+     * \note The range **must** be sorted.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     */
+    value_type * exp_ubound( value_type * first, value_type * last, value_type value )
+    {
+        return gallop(first, last, value, first, true);
+    }
+
+    /*!
+     * Returns a pointer to the first element in the range `[first, last)` that is _not less_  than (i.e. greater or equal to) `value`, or `last` if no such element is found.
+     * The search starts at `hint` and gallops outward in either direction, costing O(log d) comparisons, where d is the distance from `hint` to the answer.
+     * Passing the previous result as `hint` makes cursor-style sequential lookups cheap.
+     * \note The range **must** be sorted.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     * \param hint Where the answer is expected to be; clamped to `[first,last]`.
+     */
+    value_type * lbound_hint( value_type * first, value_type * last, value_type value, value_type * hint )
+    {
+        return gallop(first, last, value, hint, false);
+    }
+
+    /*!
+     * Returns a pointer to the first element in the range `[first, last)` that is _greater_  than `value`, or `last` if no such element is found.
+     * The search starts at `hint` and gallops outward in either direction, costing O(log d) comparisons, where d is the distance from `hint` to the answer.
+     * \note The range **must** be sorted.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param value The value we are looking for.
+     * \param hint Where the answer is expected to be; clamped to `[first,last]`.
+     */
+    value_type * ubound_hint( value_type * first, value_type * last, value_type value, value_type * hint )
+    {
+        return gallop(first, last, value, hint, true);
+    }
 }
 
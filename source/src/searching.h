@@ -4,6 +4,7 @@
  *  + upper bound
  *  + lower bound
  *  + binary search
+ *  + exponential (galloping) search, optionally starting from a hint
  *
  * \author Selan R. dos Santos
  * \date July, 31st.
@@ -35,6 +36,21 @@ namespace sa {
 
     /// Upper bound.
     value_type * ubound( value_type * first, value_type * last, value_type value );
+
+    /// Binary search (exponential, galloping from the front).
+    value_type * exp_bsearch( value_type * first, value_type * last, value_type value );
+
+    /// Lower bound (exponential, galloping from the front).
+    value_type * exp_lbound( value_type * first, value_type * last, value_type value );
+
+    /// Upper bound (exponential, galloping from the front).
+    value_type * exp_ubound( value_type * first, value_type * last, value_type value );
+
+    /// Lower bound (exponential, galloping outward from `hint`).
+    value_type * lbound_hint( value_type * first, value_type * last, value_type value, value_type * hint );
+
+    /// Upper bound (exponential, galloping outward from `hint`).
+    value_type * ubound_hint( value_type * first, value_type * last, value_type value, value_type * hint );
 }
 
 #endif // SEARCHING_H
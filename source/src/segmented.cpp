@@ -0,0 +1,215 @@
+/*!
+ * \file segmented.cpp
+ * Implementation of the segmented searches.
+ *
+ * In a sorted segment, the lower bound of `q` is simply the number of keys less than `q`, so a
+ * short segment is answered by comparing all of its keys against `q`, 8 (AVX2) or 4 (SSE2) at a
+ * time, and adding up the compare masks lane by lane. There is no data-dependent branch, and a
+ * 64-key segment takes at most 8 compares with AVX2. Up to 64 keys this beats a binary search,
+ * whose branches on the data are mispredicted about half the time.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "segmented.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sa {
+
+    namespace {
+
+        /// Segments up to this length are scanned; longer ones are binary searched.
+        const std::size_t scan_max{ 64 };
+        /// Long segments binary searched in lock step.
+        const int group_size{ 8 };
+
+#if defined(__AVX2__)
+        /// Keys compared per SIMD step.
+        const std::size_t width{ 8 };
+#else
+        /// Keys compared per SIMD step.
+        const std::size_t width{ 4 };
+#endif
+
+        /*!
+         * Number of keys of `[p,p+n)` that come before `value`: less than it, or, when `upper` is
+         * set, not greater than it.
+         *
+         * The last step loads a whole vector even if fewer keys are left, and masks off the lanes
+         * past the segment by comparing their index with `n`, so there is no scalar tail loop and
+         * its mispredicted exit; this reads up to `width - 1` keys past the segment, which the
+         * caller must allow (`overread`). Otherwise the tail is finished one key at a time.
+         */
+        template < bool upper >
+        inline std::size_t count_before( const value_type * p, std::size_t n, value_type value, bool overread )
+        {
+            // Compare masks are -1 per matching lane, so subtracting them counts matches per lane;
+            // the lanes are added up once at the end, with no popcount in the loop.
+            const std::size_t vector_end = overread ? n : n - n % width;
+            std::size_t i{0};
+#if defined(__AVX2__)
+            static_assert( sizeof(value_type) == 4, "AVX2 segmented search assumes 32-bit keys" );
+            const __m256i key = _mm256_set1_epi32( value );
+            const __m256i length = _mm256_set1_epi32( static_cast<int>( n ) );
+            const __m256i step = _mm256_set1_epi32( 8 );
+            __m256i index = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+            __m256i lanes = _mm256_setzero_si256();
+            for ( ; i < vector_end ; i += 8 ) {
+                const __m256i keys = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + i ) );
+                const __m256i match = upper ? _mm256_cmpgt_epi32( keys, key ) : _mm256_cmpgt_epi32( key, keys );
+                lanes = _mm256_sub_epi32( lanes, _mm256_and_si256( match, _mm256_cmpgt_epi32( length, index ) ) );
+                index = _mm256_add_epi32( index, step );
+            }
+            __m128i sum = _mm_add_epi32( _mm256_castsi256_si128( lanes ), _mm256_extracti128_si256( lanes, 1 ) );
+#elif defined(__SSE2__)
+            static_assert( sizeof(value_type) == 4, "SSE2 segmented search assumes 32-bit keys" );
+            const __m128i key = _mm_set1_epi32( value );
+            const __m128i length = _mm_set1_epi32( static_cast<int>( n ) );
+            const __m128i step = _mm_set1_epi32( 4 );
+            __m128i index = _mm_setr_epi32( 0, 1, 2, 3 );
+            __m128i sum = _mm_setzero_si128();
+            for ( ; i < vector_end ; i += 4 ) {
+                const __m128i keys = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p + i ) );
+                const __m128i match = upper ? _mm_cmpgt_epi32( keys, key ) : _mm_cmplt_epi32( keys, key );
+                sum = _mm_sub_epi32( sum, _mm_and_si128( match, _mm_cmpgt_epi32( length, index ) ) );
+                index = _mm_add_epi32( index, step );
+            }
+#endif
+            std::size_t count{0};
+#if defined(__AVX2__) || defined(__SSE2__)
+            sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+            sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+            const std::size_t matches = static_cast<std::size_t>( _mm_cvtsi128_si32( sum ) );
+            // For the upper bound the lanes counted keys _greater_ than `value`.
+            count = upper ? std::min( i, n ) - matches : matches;
+#else
+            (void) vector_end;
+#endif
+            for ( ; i < n ; ++i ) {
+                count += upper ? ( p[i] <= value ) : ( p[i] < value );
+            }
+            return count;
+        }
+
+        /*!
+         * Branch-free binary searches of up to `group_size` segments, one step of each per round.
+         * A search whose range is down to one key stops moving, so the rounds can run until the
+         * longest segment is done.
+         */
+        template < bool upper >
+        void search_group( const value_type * const * bases, const std::size_t * lengths, const value_type * keys,
+                           std::size_t * const * outs, int n )
+        {
+            const value_type * base[ group_size ];
+            std::size_t length[ group_size ];
+            std::size_t longest{0};
+            for ( int g{0} ; g < n ; ++g ) {
+                base[g] = bases[g];
+                length[g] = lengths[g];
+                longest = length[g] > longest ? length[g] : longest;
+            }
+            while ( longest > 1 ) {
+                for ( int g{0} ; g < n ; ++g ) {
+                    const std::size_t half = length[g] / 2;
+                    const bool before = upper ? !( keys[g] < base[g][half] ) : ( base[g][half] < keys[g] );
+                    base[g] += before ? half : 0;
+                    length[g] -= half;
+                }
+                longest -= longest / 2;
+            }
+            for ( int g{0} ; g < n ; ++g ) {
+                const value_type k = *base[g];
+                const bool before = upper ? !( keys[g] < k ) : ( k < keys[g] );
+                *outs[g] = static_cast<std::size_t>( base[g] - bases[g] ) + ( before ? 1 : 0 );
+            }
+        }
+
+        /// Shared by the lower and upper bounds.
+        template < bool upper >
+        void segmented_bound( const value_type * values, const std::size_t * offsets, std::size_t n_segments,
+                              const value_type * queries, std::size_t * out )
+        {
+            const value_type * bases[ group_size ];
+            std::size_t lengths[ group_size ];
+            value_type keys[ group_size ];
+            std::size_t * outs[ group_size ];
+            int pending{0};
+
+            // Scans may read a few keys past their segment, but not past the buffer.
+            const std::size_t end = offsets[ n_segments ];
+            for ( std::size_t s{0} ; s < n_segments ; ++s ) {
+                const std::size_t n = offsets[s + 1] - offsets[s];
+                if ( n <= scan_max ) {
+                    out[s] = count_before<upper>( values + offsets[s], n, queries[s], offsets[s] + n + width - 1 <= end );
+                    continue;
+                }
+                bases[pending] = values + offsets[s];
+                lengths[pending] = n;
+                keys[pending] = queries[s];
+                outs[pending] = out + s;
+                if ( ++pending == group_size ) {
+                    search_group<upper>( bases, lengths, keys, outs, pending );
+                    pending = 0;
+                }
+            }
+            if ( pending > 0 ) {
+                search_group<upper>( bases, lengths, keys, outs, pending );
+            }
+        }
+    }
+
+    /*!
+     * Segmented lower bound.
+     * \param values The segments, back to back; each one sorted.
+     * \param offsets `n_segments + 1` offsets into `values`: segment `s` is `[offsets[s],offsets[s+1])`.
+     * \param n_segments Number of segments.
+     * \param queries One query per segment.
+     * \param out Receives, per segment, the index of its first key _not less_ than the query, or its length.
+     */
+    void segmented_lbound( const value_type * values, const std::size_t * offsets, std::size_t n_segments,
+                           const value_type * queries, std::size_t * out )
+    {
+        segmented_bound<false>( values, offsets, n_segments, queries, out );
+    }
+
+    /*!
+     * Segmented upper bound.
+     * \param values The segments, back to back; each one sorted.
+     * \param offsets `n_segments + 1` offsets into `values`: segment `s` is `[offsets[s],offsets[s+1])`.
+     * \param n_segments Number of segments.
+     * \param queries One query per segment.
+     * \param out Receives, per segment, the index of its first key _greater_ than the query, or its length.
+     */
+    void segmented_ubound( const value_type * values, const std::size_t * offsets, std::size_t n_segments,
+                           const value_type * queries, std::size_t * out )
+    {
+        segmented_bound<true>( values, offsets, n_segments, queries, out );
+    }
+
+    /*!
+     * Segmented binary search.
+     * \param values The segments, back to back; each one sorted.
+     * \param offsets `n_segments + 1` offsets into `values`: segment `s` is `[offsets[s],offsets[s+1])`.
+     * \param n_segments Number of segments.
+     * \param queries One query per segment.
+     * \param out Receives, per segment, the index of the first key equal to the query, or its length.
+     */
+    void segmented_bsearch( const value_type * values, const std::size_t * offsets, std::size_t n_segments,
+                            const value_type * queries, std::size_t * out )
+    {
+        segmented_bound<false>( values, offsets, n_segments, queries, out );
+        for ( std::size_t s{0} ; s < n_segments ; ++s ) {
+            const std::size_t n = offsets[s + 1] - offsets[s];
+            if ( out[s] != n && values[ offsets[s] + out[s] ] != queries[s] ) {
+                out[s] = n;
+            }
+        }
+    }
+}
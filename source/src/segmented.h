@@ -0,0 +1,42 @@
+/*!
+ * \file segmented.h
+ * Batch search over many small sorted arrays stored back to back in one buffer.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef SEGMENTED_H
+#define SEGMENTED_H
+
+#include <cstddef>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * The segmented searches take a flat buffer `values` holding `n_segments` sorted arrays back
+     * to back, where segment `s` is `values[offsets[s]] ... values[offsets[s+1]-1]` (so `offsets`
+     * has `n_segments + 1` entries), and one query per segment. `out[s]` receives an index
+     * **within** segment `s`, where the segment's length plays the role of `last`.
+     *
+     * Short segments (up to 64 keys) are answered by counting, with SIMD compares, the keys that
+     * come before the query, which needs no branches on the data. Longer segments are collected
+     * in groups of 8 and binary searched in lock step, one branch-free step of every search per
+     * round, so their cache misses overlap.
+     */
+
+    /// Segmented lower bound: `out[s]` is the number of keys of segment `s` _less_ than `queries[s]`.
+    void segmented_lbound( const value_type * values, const std::size_t * offsets, std::size_t n_segments,
+                           const value_type * queries, std::size_t * out );
+
+    /// Segmented upper bound: `out[s]` is the number of keys of segment `s` _not greater_ than `queries[s]`.
+    void segmented_ubound( const value_type * values, const std::size_t * offsets, std::size_t n_segments,
+                           const value_type * queries, std::size_t * out );
+
+    /// Segmented binary search: `out[s]` is the first index of `queries[s]` in segment `s`, or the segment's length.
+    void segmented_bsearch( const value_type * values, const std::size_t * offsets, std::size_t n_segments,
+                            const value_type * queries, std::size_t * out );
+}
+
+#endif // SEGMENTED_H
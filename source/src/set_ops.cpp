@@ -0,0 +1,296 @@
+/*!
+ * \file set_ops.cpp
+ * Implementation of the sorted set operations.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "set_ops.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sa {
+
+    namespace {
+
+        /// Ranges whose lengths differ by this factor or more are galloped rather than merged.
+        const std::size_t gallop_ratio{ 32 };
+        /// The same for unions, whose merge is cheaper than a block compare.
+        const std::size_t union_gallop_ratio{ 64 };
+        /// Unions of ranges whose lengths differ by this factor or more are merged with branches.
+        const std::size_t branchy_ratio{ 3 };
+
+#if defined(__AVX2__)
+        /// Elements per block.
+        const std::size_t width{ 8 };
+#else
+        /// Elements per block.
+        const std::size_t width{ 4 };
+#endif
+
+        /// Number of bits set in a block mask (at most 8 bits).
+        inline std::size_t bit_count( unsigned mask )
+        {
+            mask = mask - ( ( mask >> 1 ) & 0x55u );
+            mask = ( mask & 0x33u ) + ( ( mask >> 2 ) & 0x33u );
+            return ( mask + ( mask >> 4 ) ) & 0x0Fu;
+        }
+
+        /// First element of `[first,last)` not less than `value`, searched from `first` by doubling steps.
+        inline const value_type * gallop( const value_type * first, const value_type * last, value_type value )
+        {
+            std::size_t step{1};
+            const value_type * low = first;
+            while ( static_cast<std::size_t>( last - low ) > step && low[step] < value ) {
+                low += step;
+                step *= 2;
+            }
+            const value_type * high = low + std::min( step + 1, static_cast<std::size_t>( last - low ) );
+            return std::lower_bound( low, high, value );
+        }
+
+        /*!
+         * Intersects `[small,small_last)` with the much longer `[large,large_last)` by galloping
+         * from the last match. Writes (when `write` is set) or counts the common elements.
+         */
+        template < bool write >
+        std::size_t intersect_gallop( const value_type * small, const value_type * small_last,
+                                      const value_type * large, const value_type * large_last, value_type * out )
+        {
+            std::size_t count{0};
+            for ( ; small != small_last && large != large_last ; ++small ) {
+                const value_type value = *small;
+                large = gallop( large, large_last, value );
+                if ( large != large_last && *large == value ) {
+                    if ( write ) {
+                        out[count] = value;
+                    }
+                    ++count;
+                    ++large;
+                }
+            }
+            return count;
+        }
+
+        /*!
+         * Intersects two ranges of similar lengths block by block. Each block of the first range
+         * is compared with every element of the current block of the second (one broadcast and
+         * compare each), giving a mask of its elements found there; then whichever block ends
+         * with the smaller element is moved past (both, if they end alike). The elements left
+         * when either range has less than a block are merged one by one.
+         *
+         * Matches are written from the first range, never ahead of where it is read, so `out`
+         * may be `a`.
+         */
+        template < bool write >
+        std::size_t intersect_blocks( const value_type * a, const value_type * a_last,
+                                      const value_type * b, const value_type * b_last, value_type * out )
+        {
+            std::size_t count{0};
+#if defined(__AVX2__) || defined(__SSE2__)
+            static_assert( sizeof(value_type) == 4, "SIMD intersection assumes 32-bit keys" );
+            while ( static_cast<std::size_t>( a_last - a ) >= width && static_cast<std::size_t>( b_last - b ) >= width ) {
+#if defined(__AVX2__)
+                const __m256i block = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a ) );
+                __m256i found = _mm256_cmpeq_epi32( block, _mm256_set1_epi32( b[0] ) );
+                for ( std::size_t j{1} ; j < width ; ++j ) {
+                    found = _mm256_or_si256( found, _mm256_cmpeq_epi32( block, _mm256_set1_epi32( b[j] ) ) );
+                }
+                unsigned mask = static_cast<unsigned>( _mm256_movemask_ps( _mm256_castsi256_ps( found ) ) );
+#else
+                const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( a ) );
+                __m128i found = _mm_cmpeq_epi32( block, _mm_set1_epi32( b[0] ) );
+                for ( std::size_t j{1} ; j < width ; ++j ) {
+                    found = _mm_or_si128( found, _mm_cmpeq_epi32( block, _mm_set1_epi32( b[j] ) ) );
+                }
+                unsigned mask = static_cast<unsigned>( _mm_movemask_ps( _mm_castsi128_ps( found ) ) );
+#endif
+                const value_type a_max = a[width - 1];
+                const value_type b_max = b[width - 1];
+                if ( write ) {
+                    for ( ; mask != 0 ; mask &= mask - 1 ) {
+                        out[count++] = a[ __builtin_ctz( mask ) ];
+                    }
+                }
+                else {
+                    count += bit_count( mask );
+                }
+                a += a_max <= b_max ? width : 0;
+                b += b_max <= a_max ? width : 0;
+            }
+#endif
+            while ( a != a_last && b != b_last ) {
+                const value_type x = *a, y = *b;
+                if ( x == y ) {
+                    if ( write ) {
+                        out[count] = x;
+                    }
+                    ++count;
+                }
+                a += x <= y;
+                b += y <= x;
+            }
+            return count;
+        }
+
+        /// Picks galloping or block merging for the lengths of the two ranges.
+        template < bool write >
+        std::size_t intersect_any( const value_type * first1, const value_type * last1,
+                                   const value_type * first2, const value_type * last2, value_type * out )
+        {
+            const std::size_t n1 = static_cast<std::size_t>( last1 - first1 );
+            const std::size_t n2 = static_cast<std::size_t>( last2 - first2 );
+            if ( n1 == 0 || n2 == 0 ) {
+                return 0;
+            }
+            if ( n2 / n1 >= gallop_ratio ) {
+                return intersect_gallop<write>( first1, last1, first2, last2, out );
+            }
+            if ( n1 / n2 >= gallop_ratio ) {
+                return intersect_gallop<write>( first2, last2, first1, last1, out );
+            }
+            return intersect_blocks<write>( first1, last1, first2, last2, out );
+        }
+    }
+
+    /*!
+     * Intersects two sorted sets.
+     * \param first1 Pointer to the begining of the first range.
+     * \param last1 Pointer just past the last element of the first range.
+     * \param first2 Pointer to the begining of the second range.
+     * \param last2 Pointer just past the last element of the second range.
+     * \param out Where to write the result; room for the shorter range is enough.
+     * \return A pointer just past the last element written.
+     */
+    value_type * intersect( const value_type * first1, const value_type * last1,
+                            const value_type * first2, const value_type * last2, value_type * out )
+    {
+        return out + intersect_any<true>( first1, last1, first2, last2, out );
+    }
+
+    /*!
+     * Counts the common elements of two sorted sets, without writing them.
+     * \param first1 Pointer to the begining of the first range.
+     * \param last1 Pointer just past the last element of the first range.
+     * \param first2 Pointer to the begining of the second range.
+     * \param last2 Pointer just past the last element of the second range.
+     * \return The size of the intersection.
+     */
+    std::size_t intersect_count( const value_type * first1, const value_type * last1,
+                                 const value_type * first2, const value_type * last2 )
+    {
+        return intersect_any<false>( first1, last1, first2, last2, nullptr );
+    }
+
+    /*!
+     * Unites two sorted sets. When one is much longer, the runs of it between consecutive
+     * elements of the other are found by galloping and copied whole. Otherwise the two are
+     * merged: without branching on the data when their lengths are close, since the order then
+     * alternates unpredictably, and with branches when they are not, since long runs from the
+     * longer range make them predictable.
+     * \param first1 Pointer to the begining of the first range.
+     * \param last1 Pointer just past the last element of the first range.
+     * \param first2 Pointer to the begining of the second range.
+     * \param last2 Pointer just past the last element of the second range.
+     * \param out Where to write the result; room for both ranges is enough.
+     * \return A pointer just past the last element written.
+     */
+    value_type * set_union( const value_type * first1, const value_type * last1,
+                            const value_type * first2, const value_type * last2, value_type * out )
+    {
+        const std::size_t n1 = static_cast<std::size_t>( last1 - first1 );
+        const std::size_t n2 = static_cast<std::size_t>( last2 - first2 );
+        const std::size_t ratio = std::max( n1, n2 ) / std::max<std::size_t>( std::min( n1, n2 ), 1 );
+        if ( ratio >= union_gallop_ratio ) {
+            const value_type * small = n1 < n2 ? first1 : first2;
+            const value_type * small_last = n1 < n2 ? last1 : last2;
+            const value_type * large = n1 < n2 ? first2 : first1;
+            const value_type * large_last = n1 < n2 ? last2 : last1;
+            for ( ; small != small_last ; ++small ) {
+                const value_type * run_last = gallop( large, large_last, *small );
+                out = std::copy( large, run_last, out );
+                large = run_last != large_last && *run_last == *small ? run_last + 1 : run_last;
+                *out++ = *small;
+            }
+            return std::copy( large, large_last, out );
+        }
+
+        if ( ratio < branchy_ratio ) {
+            std::size_t i{0}, j{0};
+            while ( i < n1 && j < n2 ) {
+                const value_type x = first1[i], y = first2[j];
+                const value_type smaller = x < y ? x : y;
+                *out++ = smaller;
+                i += x == smaller;
+                j += y == smaller;
+            }
+            first1 += i;
+            first2 += j;
+        }
+        else {
+            while ( first1 != last1 && first2 != last2 ) {
+                if ( *first1 < *first2 ) {
+                    *out++ = *first1++;
+                }
+                else if ( *first2 < *first1 ) {
+                    *out++ = *first2++;
+                }
+                else {
+                    *out++ = *first1++;
+                    ++first2;
+                }
+            }
+        }
+        out = std::copy( first1, last1, out );
+        return std::copy( first2, last2, out );
+    }
+
+    /*!
+     * Intersects many sorted sets. The lists are taken by increasing length (ties in the order
+     * given), each one intersected with the result so far.
+     * \param lists The ranges, as `[first,last)` pairs.
+     * \param n_lists Number of ranges.
+     * \param out Where to write the result; room for the shortest range is enough.
+     * \return A pointer just past the last element written (`out` if there are no lists).
+     */
+    value_type * intersect( const std::pair<const value_type *, const value_type *> * lists, std::size_t n_lists,
+                            value_type * out )
+    {
+        // Selects the lists in (length, position) order by repeated scans, which needs no memory.
+        auto length = [lists]( std::size_t l ) { return static_cast<std::size_t>( lists[l].second - lists[l].first ); };
+        auto next = [&]( std::size_t previous ) {
+            std::size_t best{ n_lists };
+            for ( std::size_t l{0} ; l < n_lists ; ++l ) {
+                bool after = previous == n_lists || length( l ) > length( previous )
+                          || ( length( l ) == length( previous ) && l > previous );
+                bool before_best = best == n_lists || length( l ) < length( best );
+                if ( after && before_best ) {
+                    best = l;
+                }
+            }
+            return best;
+        };
+
+        std::size_t l = next( n_lists );
+        if ( l == n_lists ) {
+            return out;
+        }
+        if ( n_lists == 1 ) {
+            return std::copy( lists[l].first, lists[l].second, out );
+        }
+        std::size_t shortest = l;
+        l = next( l );
+        value_type * out_last = intersect( lists[shortest].first, lists[shortest].second, lists[l].first, lists[l].second, out );
+        for ( std::size_t step{2} ; step < n_lists && out_last != out ; ++step ) {
+            l = next( l );
+            out_last = intersect( out, out_last, lists[l].first, lists[l].second, out );
+        }
+        return out_last;
+    }
+}
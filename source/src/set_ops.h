@@ -0,0 +1,49 @@
+/*!
+ * \file set_ops.h
+ * Intersection and union of sorted sets of `value_type`, such as posting lists.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef SET_OPS_H
+#define SET_OPS_H
+
+#include <cstddef>
+#include <utility>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * The set operations take ranges sorted in **strictly** increasing order (sets, as left by
+     * `sa::dedup`) and write into a caller-supplied buffer, allocating nothing.
+     *
+     * Ranges of similar sizes are merged block by block: a SIMD block of one range is compared
+     * with every element of a block of the other at once, and the block with the smaller last
+     * element is moved past. When one range is much longer than the other (32 times or more, 64
+     * for unions), each element of the shorter one is instead galloped to in the longer one.
+     */
+
+    /// Writes the elements common to both ranges to `out` (which may be `first1`, for in-place use); returns the end of the output.
+    value_type * intersect( const value_type * first1, const value_type * last1,
+                            const value_type * first2, const value_type * last2, value_type * out );
+
+    /// Number of elements common to both ranges.
+    std::size_t intersect_count( const value_type * first1, const value_type * last1,
+                                 const value_type * first2, const value_type * last2 );
+
+    /// Writes the elements of either range to `out` (which must not overlap them); returns the end of the output.
+    value_type * set_union( const value_type * first1, const value_type * last1,
+                            const value_type * first2, const value_type * last2, value_type * out );
+
+    /*!
+     * Writes the elements common to all `n_lists` ranges to `out`, which must hold as many
+     * elements as the shortest range; returns the end of the output. The ranges are intersected
+     * shortest first, in place in `out`, stopping as soon as the result is empty.
+     */
+    value_type * intersect( const std::pair<const value_type *, const value_type *> * lists, std::size_t n_lists,
+                            value_type * out );
+}
+
+#endif // SET_OPS_H
@@ -0,0 +1,286 @@
+/*!
+ * \file sorting.cpp
+ * Implementation of the build stage for searchable arrays.
+ *
+ * `radix_sort` makes one parallel MSD pass on the top byte: every thread histograms its chunk,
+ * the histograms are turned into per-thread offsets, and every thread scatters its chunk into
+ * the 256 buckets. The buckets are then independent, so the threads take them one at a time and
+ * finish each with an LSD sort on the three low bytes, which for most inputs runs in cache.
+ * LSD passes whose digit is the same for every key are skipped. Keys are compared as signed by
+ * flipping the sign bit of the top digit.
+ *
+ * `is_sorted` compares each SIMD block with the same block shifted by one element, so it needs
+ * one load pair and one compare per 4 (SSE2) or 8 (AVX2) keys; large ranges are split across
+ * threads, which stop early once any of them finds an inversion.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "sorting.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sa {
+
+    namespace {
+
+        using key_type = std::uint32_t;
+
+        /// Bits per radix digit.
+        const int digit_bits{ 8 };
+        /// Buckets per radix digit.
+        const std::size_t n_buckets{ 1u << digit_bits };
+        /// Below this many keys, sorting is not worth spreading over threads.
+        const std::size_t parallel_min{ 1u << 16 };
+        /// Below this many keys, a comparison sort is faster than counting.
+        const std::size_t radix_min{ 64 };
+        /// Keys checked between two looks at the other threads' early-exit flag.
+        const std::size_t check_block{ 1u << 14 };
+
+        /// Digit `d` (0 is the least significant) of `value`, in signed order.
+        inline std::size_t digit( value_type value, int d )
+        {
+            const key_type key = static_cast<key_type>( value ) ^ 0x80000000u;
+            return ( key >> ( d * digit_bits ) ) & ( n_buckets - 1 );
+        }
+
+        /// The number of worker threads to use for `n` items.
+        unsigned workers_for( std::size_t n, unsigned n_threads, std::size_t min_per_thread )
+        {
+            if ( n_threads == 0 ) {
+                n_threads = std::max( 1u, std::thread::hardware_concurrency() );
+            }
+            std::size_t useful = std::max<std::size_t>( 1, n / min_per_thread );
+            return static_cast<unsigned>( std::min<std::size_t>( n_threads, useful ) );
+        }
+
+        /// Runs `work(w)` for every `w` in `[0,n_workers)`, worker 0 on the calling thread.
+        template < typename Work >
+        void run_workers( unsigned n_workers, Work work )
+        {
+            std::vector<std::thread> workers;
+            for ( unsigned w{1} ; w < n_workers ; ++w ) {
+                workers.push_back( std::thread( work, w ) );
+            }
+            work( 0 );
+            for ( auto & t : workers ) {
+                t.join();
+            }
+        }
+
+        /*!
+         * Sequential LSD radix sort of `[first,last)` on digits `[0,n_digits)`, using `buffer`
+         * (same length) as scratch.
+         * \return Where the sorted keys ended up: `first` or `buffer`.
+         */
+        value_type * lsd_sort( value_type * first, value_type * last, value_type * buffer, int n_digits )
+        {
+            const std::size_t n = static_cast<std::size_t>( last - first );
+            if ( n < radix_min ) {
+                std::sort( first, last );
+                return first;
+            }
+
+            // All histograms in one read of the data.
+            std::vector<std::size_t> counts( n_digits * n_buckets, 0 );
+            for ( const value_type * p = first ; p != last ; ++p ) {
+                for ( int d{0} ; d < n_digits ; ++d ) {
+                    ++counts[ d * n_buckets + digit( *p, d ) ];
+                }
+            }
+
+            value_type * from = first;
+            value_type * to = buffer;
+            for ( int d{0} ; d < n_digits ; ++d ) {
+                std::size_t * count = counts.data() + d * n_buckets;
+                if ( count[ digit( *from, d ) ] == n ) {
+                    continue;  // Every key has the same digit: nothing moves.
+                }
+                std::size_t offset{0};
+                for ( std::size_t b{0} ; b < n_buckets ; ++b ) {
+                    std::size_t c = count[b];
+                    count[b] = offset;
+                    offset += c;
+                }
+                for ( std::size_t i{0} ; i < n ; ++i ) {
+                    to[ count[ digit( from[i], d ) ]++ ] = from[i];
+                }
+                std::swap( from, to );
+            }
+            return from;
+        }
+
+        /// Whether `[first,last)` is sorted, checked sequentially with SIMD.
+        bool sorted_block( const value_type * first, const value_type * last )
+        {
+            std::ptrdiff_t n = last - first;
+            std::ptrdiff_t i{0};
+#if defined(__AVX2__)
+            static_assert( sizeof(value_type) == 4, "AVX2 sortedness check assumes 32-bit keys" );
+            __m256i inversions = _mm256_setzero_si256();
+            for ( ; i + 8 < n ; i += 8 ) {
+                const __m256i a = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( first + i ) );
+                const __m256i b = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( first + i + 1 ) );
+                inversions = _mm256_or_si256( inversions, _mm256_cmpgt_epi32( a, b ) );
+            }
+            if ( not _mm256_testz_si256( inversions, inversions ) ) {
+                return false;
+            }
+#elif defined(__SSE2__)
+            static_assert( sizeof(value_type) == 4, "SSE2 sortedness check assumes 32-bit keys" );
+            __m128i inversions = _mm_setzero_si128();
+            for ( ; i + 4 < n ; i += 4 ) {
+                const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( first + i ) );
+                const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( first + i + 1 ) );
+                inversions = _mm_or_si128( inversions, _mm_cmpgt_epi32( a, b ) );
+            }
+            if ( _mm_movemask_epi8( inversions ) != 0 ) {
+                return false;
+            }
+#endif
+            for ( ; i + 1 < n ; ++i ) {
+                if ( first[i + 1] < first[i] ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    /*!
+     * Sorts `[first,last)` in non-decreasing order with a parallel radix sort.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param n_threads Number of threads to use; 0 means one per hardware thread.
+     */
+    void radix_sort( value_type * first, value_type * last, unsigned n_threads )
+    {
+        const std::size_t n = static_cast<std::size_t>( last - first );
+        std::vector<value_type> buffer( n );
+        const unsigned n_workers = workers_for( n, n_threads, parallel_min );
+        if ( n_workers == 1 ) {
+            if ( lsd_sort( first, last, buffer.data(), static_cast<int>( sizeof(value_type) ) ) != first ) {
+                std::copy( buffer.begin(), buffer.end(), first );
+            }
+            return;
+        }
+
+        // [1] MSD pass on the top byte, from `first` into `buffer`.
+        const int top = static_cast<int>( sizeof(value_type) ) - 1;
+        const std::size_t chunk = ( n + n_workers - 1 ) / n_workers;
+        std::vector<std::size_t> counts( n_workers * n_buckets, 0 );
+        run_workers( n_workers, [&]( unsigned w ) {
+            std::size_t * count = counts.data() + w * n_buckets;
+            const std::size_t end = std::min( n, ( w + 1 ) * chunk );
+            for ( std::size_t i = w * chunk ; i < end ; ++i ) {
+                ++count[ digit( first[i], top ) ];
+            }
+        } );
+
+        // Offsets, bucket-major then thread, so the scatter is stable.
+        std::vector<std::size_t> bucket_first( n_buckets + 1, 0 );
+        std::size_t offset{0};
+        for ( std::size_t b{0} ; b < n_buckets ; ++b ) {
+            bucket_first[b] = offset;
+            for ( unsigned w{0} ; w < n_workers ; ++w ) {
+                std::size_t c = counts[ w * n_buckets + b ];
+                counts[ w * n_buckets + b ] = offset;
+                offset += c;
+            }
+        }
+        bucket_first[ n_buckets ] = n;
+
+        value_type * scratch = buffer.data();
+        run_workers( n_workers, [&]( unsigned w ) {
+            std::size_t * count = counts.data() + w * n_buckets;
+            const std::size_t end = std::min( n, ( w + 1 ) * chunk );
+            for ( std::size_t i = w * chunk ; i < end ; ++i ) {
+                scratch[ count[ digit( first[i], top ) ]++ ] = first[i];
+            }
+        } );
+
+        // [2] The buckets are independent: LSD-sort each on the low bytes, back into `first`.
+        std::atomic<std::size_t> next{0};
+        run_workers( n_workers, [&]( unsigned ) {
+            for ( std::size_t b = next++ ; b < n_buckets ; b = next++ ) {
+                const std::size_t lo = bucket_first[b], hi = bucket_first[b + 1];
+                if ( lsd_sort( scratch + lo, scratch + hi, first + lo, top ) != first + lo ) {
+                    std::copy( scratch + lo, scratch + hi, first + lo );
+                }
+            }
+        } );
+    }
+
+    /*!
+     * Removes consecutive repeated values, keeping the first of each run (as `std::unique`).
+     * \param first Pointer to the begining of the (sorted) data range.
+     * \param last Pointer just past the last element of the data range.
+     * \return The new end of the range.
+     */
+    value_type * dedup( value_type * first, value_type * last )
+    {
+        if ( first == last ) {
+            return last;
+        }
+        value_type * out = first + 1;
+        for ( const value_type * p = first + 1 ; p != last ; ++p ) {
+            // Branch-free: always write, and only advance past a new value.
+            *out = *p;
+            out += ( *p != out[-1] );
+        }
+        return out;
+    }
+
+    /*!
+     * Checks whether `[first,last)` is sorted in non-decreasing order.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param n_threads Number of threads to use; 0 means one per hardware thread.
+     * \return `true` if no element is less than the one before it.
+     */
+    bool is_sorted( const value_type * first, const value_type * last, unsigned n_threads )
+    {
+        const std::size_t n = static_cast<std::size_t>( last - first );
+        const unsigned n_workers = workers_for( n, n_threads, parallel_min );
+        const std::size_t chunk = ( n + n_workers - 1 ) / n_workers;
+        std::atomic<bool> sorted{ true };
+
+        run_workers( n_workers, [&]( unsigned w ) {
+            const std::size_t begin = std::min( n, w * chunk );
+            // Each chunk overlaps the next by one key, so the pair across the border is checked too.
+            const std::size_t end = std::min( n, ( w + 1 ) * chunk + 1 );
+            for ( std::size_t i = begin ; i < end && sorted.load( std::memory_order_relaxed ) ; i += check_block ) {
+                if ( not sorted_block( first + i, first + std::min( end, i + check_block + 1 ) ) ) {
+                    sorted.store( false, std::memory_order_relaxed );
+                }
+            }
+        } );
+        return sorted.load();
+    }
+
+    /*!
+     * Validates the precondition of the binary searches.
+     * \param first Pointer to the begining of the data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param n_threads Number of threads to use; 0 means one per hardware thread.
+     * \throw std::invalid_argument if `[first,last)` is not sorted.
+     */
+    void require_sorted( const value_type * first, const value_type * last, unsigned n_threads )
+    {
+        if ( not is_sorted( first, last, n_threads ) ) {
+            throw std::invalid_argument( "sa: the range to search is not sorted" );
+        }
+    }
+}
@@ -0,0 +1,28 @@
+/*!
+ * \file sorting.h
+ * Preparing searchable arrays: parallel radix sort, dedup, and a fast sortedness check.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef SORTING_H
+#define SORTING_H
+
+#include "searching.h"
+
+namespace sa {
+
+    /// Sorts `[first,last)` with a parallel radix sort; `n_threads = 0` uses every hardware thread.
+    void radix_sort( value_type * first, value_type * last, unsigned n_threads=0 );
+
+    /// Removes consecutive repeated values from a sorted range; returns the new `last`.
+    value_type * dedup( value_type * first, value_type * last );
+
+    /// Whether `[first,last)` is sorted (non-decreasing); `n_threads = 0` uses every hardware thread.
+    bool is_sorted( const value_type * first, const value_type * last, unsigned n_threads=0 );
+
+    /// Throws `std::invalid_argument` unless `[first,last)` is sorted; meant for checked/debug builds.
+    void require_sorted( const value_type * first, const value_type * last, unsigned n_threads=0 );
+}
+
+#endif // SORTING_H
@@ -0,0 +1,176 @@
+/*!
+ * \file string_index.cpp
+ * Implementation of the prefix-inlined sorted string index.
+ * \date October 19th, 2026.
+ */
+
+#include "string_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace sa {
+
+    const std::size_t string_index::prefix_bytes;
+
+    namespace {
+
+        static_assert( sizeof(value_type) == sizeof(std::uint32_t), "prefixes are packed as 32-bit integers" );
+
+        /*!
+         * Packs the first bytes of a key, zero padded, as a big-endian unsigned integer, and
+         * flips its sign bit so that signed comparison of the result matches byte order.
+         */
+        value_type encode_prefix( const char * key, std::size_t len )
+        {
+            std::uint32_t packed{0};
+            for ( std::size_t b{0} ; b < string_index::prefix_bytes ; ++b ) {
+                unsigned char byte = b < len ? static_cast<unsigned char>( key[b] ) : 0;
+                packed = ( packed << 8 ) | byte;
+            }
+            packed ^= 0x80000000u;
+            value_type prefix;
+            std::memcpy( &prefix, &packed, sizeof(prefix) );
+            return prefix;
+        }
+    }
+
+    /*!
+     * Builds the index.
+     * \param keys The keys, in any order.
+     * \throw std::length_error if the keys do not fit in 4 GiB.
+     */
+    string_index::string_index( std::vector<std::string> keys )
+    {
+        std::sort( keys.begin(), keys.end() );
+
+        m_prefixes.reserve( keys.size() );
+        m_lengths.reserve( keys.size() );
+        m_offsets.reserve( keys.size() + 1 );
+        for ( const auto & k : keys ) {
+            if ( m_arena.size() + k.size() > std::numeric_limits<std::uint32_t>::max() ) {
+                throw std::length_error( "string_index: keys too large" );
+            }
+            m_prefixes.push_back( encode_prefix( k.data(), k.size() ) );
+            m_lengths.push_back( static_cast<std::uint32_t>( k.size() ) );
+            m_offsets.push_back( static_cast<std::uint32_t>( m_arena.size() ) );
+            if ( k.size() > prefix_bytes ) {
+                m_arena.insert( m_arena.end(), k.begin() + prefix_bytes, k.end() );
+            }
+        }
+        m_offsets.push_back( static_cast<std::uint32_t>( m_arena.size() ) );
+    }
+
+    /*!
+     * Compares key `i` with `key`, assuming their prefixes are equal.
+     * Past the prefix the rest of the bytes decide; if one key is a prefix of the other (possibly
+     * because of the zero padding of short keys) the shorter one is smaller.
+     * \return A negative number, zero, or a positive number if key `i` is less than, equal to, or greater than `key`.
+     */
+    int string_index::compare_rest( std::size_t i, const char * key, std::size_t len ) const
+    {
+        const std::size_t rest_len = m_offsets[i + 1] - m_offsets[i];
+        const std::size_t key_rest_len = len > prefix_bytes ? len - prefix_bytes : 0;
+        const std::size_t common = std::min( rest_len, key_rest_len );
+
+        if ( common > 0 ) {
+            int cmp = std::memcmp( m_arena.data() + m_offsets[i], key + prefix_bytes, common );
+            if ( cmp != 0 ) {
+                return cmp;
+            }
+        }
+        if ( m_lengths[i] != len ) {
+            return m_lengths[i] < len ? -1 : 1;
+        }
+        return 0;
+    }
+
+    std::size_t string_index::bound( const char * key, std::size_t len, bool upper ) const
+    {
+        const value_type prefix = encode_prefix( key, len );
+        // The integer searches take mutable pointers, but never write through them.
+        value_type* first = const_cast<value_type*>( m_prefixes.data() );
+        value_type* last = first + m_prefixes.size();
+
+        // Keys sharing the prefix of `key`; only these need the arena.
+        value_type* lo = sa::lbound( first, last, prefix );
+        value_type* hi = sa::ubound( lo, last, prefix );
+
+        std::size_t l = static_cast<std::size_t>( lo - first );
+        std::size_t h = static_cast<std::size_t>( hi - first );
+        while ( l < h ) {
+            std::size_t middle = l + ( h - l ) / 2;
+            int cmp = compare_rest( middle, key, len );
+            if ( upper ? cmp <= 0 : cmp < 0 ) {
+                l = middle + 1;
+            }
+            else {
+                h = middle;
+            }
+        }
+        return l;
+    }
+
+    /*!
+     * Returns the position of the first key in the index that is _not less_ than `key`, or `size()` if there is no such key.
+     * \param key The bytes of the key we are looking for.
+     * \param len Length of `key`.
+     */
+    std::size_t string_index::lbound( const char * key, std::size_t len ) const
+    {
+        return bound( key, len, false );
+    }
+
+    /*!
+     * Returns the position of the first key in the index that is _greater_ than `key`, or `size()` if there is no such key.
+     * \param key The bytes of the key we are looking for.
+     * \param len Length of `key`.
+     */
+    std::size_t string_index::ubound( const char * key, std::size_t len ) const
+    {
+        return bound( key, len, true );
+    }
+
+    /*!
+     * Returns the position of a key equal to `key`, or `size()` if no such key is found.
+     * \param key The bytes of the key we are looking for.
+     * \param len Length of `key`.
+     */
+    std::size_t string_index::find( const char * key, std::size_t len ) const
+    {
+        std::size_t pos = bound( key, len, false );
+        if ( pos != size() && m_prefixes[pos] == encode_prefix( key, len ) && compare_rest( pos, key, len ) == 0 ) {
+            return pos;
+        }
+        return size();
+    }
+
+    /*!
+     * Rebuilds the key at position `i` from its inline prefix and the arena.
+     * \param i A position in `[0,size())`.
+     */
+    std::string string_index::key( std::size_t i ) const
+    {
+        std::uint32_t packed;
+        std::memcpy( &packed, &m_prefixes[i], sizeof(packed) );
+        packed ^= 0x80000000u;
+
+        std::string result( m_lengths[i], '\0' );
+        for ( std::size_t b{0} ; b < prefix_bytes && b < result.size() ; ++b ) {
+            result[b] = static_cast<char>( ( packed >> ( 8 * ( prefix_bytes - 1 - b ) ) ) & 0xFF );
+        }
+        if ( result.size() > prefix_bytes ) {
+            std::copy( m_arena.begin() + m_offsets[i], m_arena.begin() + m_offsets[i + 1], result.begin() + prefix_bytes );
+        }
+        return result;
+    }
+
+    std::size_t string_index::memory_bytes( void ) const
+    {
+        return m_prefixes.size() * sizeof(value_type)
+             + ( m_lengths.size() + m_offsets.size() ) * sizeof(std::uint32_t)
+             + m_arena.size();
+    }
+}
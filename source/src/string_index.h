@@ -0,0 +1,77 @@
+/*!
+ * \file string_index.h
+ * A sorted index over string keys that does most of its work with the integer searches.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef STRING_INDEX_H
+#define STRING_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * Sorted index over string keys (SKUs, hostnames, ...).
+     *
+     * The first `prefix_bytes` bytes of every key are stored inline, as a big-endian integer
+     * remapped to `value_type` so that integer order is byte order, in a dense array searched
+     * with `sa::lbound`/`sa::ubound`. The rest of each key lives in a separate arena and is only
+     * compared when several keys share the searched prefix. Most probes therefore touch the
+     * dense prefix array alone, and never chase a pointer.
+     *
+     * Keys are compared as `std::string` does (byte-wise, shorter prefix first). Results are
+     * positions in the index order, i.e. in the sorted order of the keys.
+     */
+    class string_index {
+        public:
+            /// Bytes of each key kept inline in the prefix array.
+            static const std::size_t prefix_bytes = sizeof(value_type);
+
+            /// Builds the index from `keys` (in any order; repetitions are kept).
+            explicit string_index( std::vector<std::string> keys );
+
+            /// Position of the first key _not less_ than `key`, or `size()`.
+            std::size_t lbound( const char * key, std::size_t len ) const;
+            /// Position of the first key _not less_ than `key`, or `size()`.
+            std::size_t lbound( const std::string & key ) const { return lbound( key.data(), key.size() ); }
+
+            /// Position of the first key _greater_ than `key`, or `size()`.
+            std::size_t ubound( const char * key, std::size_t len ) const;
+            /// Position of the first key _greater_ than `key`, or `size()`.
+            std::size_t ubound( const std::string & key ) const { return ubound( key.data(), key.size() ); }
+
+            /// Position of a key equal to `key`, or `size()` if there is none.
+            std::size_t find( const char * key, std::size_t len ) const;
+            /// Position of a key equal to `key`, or `size()` if there is none.
+            std::size_t find( const std::string & key ) const { return find( key.data(), key.size() ); }
+
+            /// The key at position `i`.
+            std::string key( std::size_t i ) const;
+
+            /// Number of keys.
+            std::size_t size( void ) const { return m_prefixes.size(); }
+
+            /// Bytes used by the index.
+            std::size_t memory_bytes( void ) const;
+
+        private:
+            std::vector<value_type> m_prefixes;    //!< Inline key prefixes, in key order.
+            std::vector<std::uint32_t> m_lengths;  //!< Full length of each key.
+            std::vector<std::uint32_t> m_offsets;  //!< Where the rest of key `i` starts in the arena; one extra entry at the end.
+            std::vector<char> m_arena;             //!< The bytes past the prefix of every key, one after the other.
+
+            /// Compares the part past the prefix of key `i` with `key`, as `std::string::compare` would.
+            int compare_rest( std::size_t i, const char * key, std::size_t len ) const;
+            /// Narrows to the keys sharing `key`'s prefix, then finds the lower (or upper) bound among them.
+            std::size_t bound( const char * key, std::size_t len, bool upper ) const;
+    };
+}
+
+#endif // STRING_INDEX_H
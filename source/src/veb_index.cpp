@@ -0,0 +1,129 @@
+/*!
+ * \file veb_index.cpp
+ * Implementation of the van Emde Boas layout index.
+ *
+ * Nodes are named by their 1-based BFS index `i` (children `2i` and `2i+1`). Every depth `d > 0`
+ * is the root depth of the bottom trees of exactly one split of the recursion; if that split's
+ * top tree has its root at depth `D`, size `T = 2^t - 1` and its bottom trees have size `B`, then
+ *
+ *     pos[d] = pos[D] + T + (i & T) * B,
+ *
+ * since the bottom trees follow the top tree in left-to-right order and the low `t` bits of `i`
+ * say which of them the node roots. A search keeps `pos[]` for the depths of its path.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "veb_index.h"
+
+#include <limits>
+
+namespace sa {
+
+    /*!
+     * Builds the layout.
+     * \param first Pointer to the begining of the (sorted) data range.
+     * \param last Pointer just past the last element of the data range.
+     */
+    veb_index::veb_index( value_type * first, value_type * last )
+        : m_first{ first }, m_size{ static_cast<std::size_t>( last - first ) }, m_height{ 0 }
+    {
+        while ( ( std::uint64_t{1} << m_height ) - 1 < m_size ) {
+            ++m_height;
+        }
+        m_levels.assign( m_height > 0 ? m_height : 1, level_t{ 0, 0, 0 } );
+        split( 0, m_height );
+
+        const std::uint64_t n_nodes = ( std::uint64_t{1} << m_height ) - 1;
+        m_tree.assign( n_nodes, std::numeric_limits<value_type>::max() );
+
+        // Place every node: its in-order rank is its key's index in the sorted range.
+        std::vector<std::uint64_t> pos( m_levels.size() + 1, 0 );
+        for ( std::uint64_t i{1} ; i <= n_nodes ; ++i ) {
+            int depth{0};
+            while ( ( i >> ( depth + 1 ) ) != 0 ) {
+                ++depth;
+            }
+            for ( int d{1} ; d <= depth ; ++d ) {
+                const level_t & level = m_levels[d];
+                pos[d] = pos[level.top_depth] + level.top_size + ( ( i >> ( depth - d ) ) & level.top_size ) * level.bottom_size;
+            }
+            const int below = m_height - depth;
+            const std::uint64_t rank = ( i - ( std::uint64_t{1} << depth ) ) * ( std::uint64_t{1} << below )
+                                     + ( std::uint64_t{1} << ( below - 1 ) ) - 1;
+            if ( rank < m_size ) {
+                m_tree[ pos[depth] ] = first[rank];
+            }
+        }
+    }
+
+    void veb_index::split( int depth, int height )
+    {
+        if ( height <= 1 ) {
+            return;
+        }
+        const int top = height / 2;
+        const int bottom = height - top;
+        level_t & level = m_levels[ depth + top ];
+        level.top_size = ( std::uint64_t{1} << top ) - 1;
+        level.bottom_size = ( std::uint64_t{1} << bottom ) - 1;
+        level.top_depth = depth;
+        split( depth, top );
+        split( depth + top, bottom );
+    }
+
+    /*!
+     * Walks from the root to an external node, going left when the key is not less than `value`
+     * (or, for `upper`, when it is greater). The external node reached, counted from the left, is
+     * the number of keys that come before `value`.
+     */
+    std::size_t veb_index::descend( value_type value, bool upper ) const
+    {
+        std::uint64_t pos[64];
+        std::uint64_t i{1};
+        pos[0] = 0;
+        for ( int d{0} ; d < m_height ; ++d ) {
+            if ( d > 0 ) {
+                const level_t & level = m_levels[d];
+                pos[d] = pos[level.top_depth] + level.top_size + ( i & level.top_size ) * level.bottom_size;
+            }
+            const value_type key = m_tree[ pos[d] ];
+            const bool right = upper ? !( value < key ) : ( key < value );
+            i = 2 * i + ( right ? 1 : 0 );
+        }
+        const std::uint64_t before = i - ( std::uint64_t{1} << m_height );
+        return before < m_size ? static_cast<std::size_t>( before ) : m_size;
+    }
+
+    /*!
+     * Returns a pointer to the first element of the original range that is _not less_ than `value`.
+     * \param value The value we are looking for.
+     * \return A pointer into the original range, or its `last` if no such element is found.
+     */
+    value_type * veb_index::lbound( value_type value ) const
+    {
+        return m_first + descend( value, false );
+    }
+
+    /*!
+     * Returns a pointer to the first element of the original range that is _greater_ than `value`.
+     * \param value The value we are looking for.
+     * \return A pointer into the original range, or its `last` if no such element is found.
+     */
+    value_type * veb_index::ubound( value_type value ) const
+    {
+        return m_first + descend( value, true );
+    }
+
+    /*!
+     * Performs a **binary search** for `value` in the layout.
+     * \param value The value we are looking for.
+     * \return A pointer to the first occurrence of `value` in the original range, or its `last` if there is none.
+     */
+    value_type * veb_index::bsearch( value_type value ) const
+    {
+        value_type * last = m_first + m_size;
+        value_type * lb = lbound( value );
+        return ( lb != last && *lb == value ) ? lb : last;
+    }
+}
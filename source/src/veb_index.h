@@ -0,0 +1,79 @@
+/*!
+ * \file veb_index.h
+ * Cache-oblivious search over a sorted array stored in the van Emde Boas layout.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef VEB_INDEX_H
+#define VEB_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * A copy of a sorted range laid out as a complete binary search tree in **van Emde Boas**
+     * order: the tree is split at half its height into a top tree and the bottom trees hanging
+     * from it, each of which is stored contiguously and laid out the same way, recursively.
+     *
+     * Whatever the size B of a cache line, page or disk block, a search path then crosses only
+     * O(log_B n) blocks, so the layout suits every level of the memory hierarchy at once with no
+     * tuning. Node positions are computed on the fly from per-depth tables (Brodal, Fagerberg and
+     * Jacob), so no child pointers are stored.
+     *
+     * The tree is padded to 2^h - 1 keys with the largest `value_type`. Results are pointers into
+     * the **original** range and match `sa::lbound`/`sa::ubound`; `bsearch` finds the first
+     * occurrence of the value.
+     *
+     * \note The original range must outlive the index, since results point into it.
+     */
+    class veb_index {
+        public:
+            /// Builds the layout from the sorted range `[first,last)`.
+            veb_index( value_type * first, value_type * last );
+
+            /// Lower bound of `value`, as a pointer into the original range.
+            value_type * lbound( value_type value ) const;
+
+            /// Upper bound of `value`, as a pointer into the original range.
+            value_type * ubound( value_type value ) const;
+
+            /// Location of `value` in the original range, or its `last` if there is none.
+            value_type * bsearch( value_type value ) const;
+
+            /// Number of keys indexed.
+            std::size_t size( void ) const { return m_size; }
+
+            /// Height of the tree.
+            int height( void ) const { return m_height; }
+
+            /// Bytes used by the layout, padding included.
+            std::size_t memory_bytes( void ) const { return m_tree.size() * sizeof(value_type); }
+
+        private:
+            /// Where the node at a given depth sits, relative to its top tree's root.
+            struct level_t {
+                std::uint64_t top_size;    //!< Size (and low-bit mask) of the top tree it hangs from.
+                std::uint64_t bottom_size; //!< Size of the bottom tree it is the root of.
+                int top_depth;             //!< Depth of the root of that top tree.
+            };
+
+            value_type * m_first;           //!< The original range.
+            std::size_t m_size;             //!< Number of keys.
+            int m_height;                   //!< Height of the padded tree.
+            std::vector<level_t> m_levels;  //!< One per depth.
+            std::vector<value_type> m_tree; //!< The keys, in van Emde Boas order.
+
+            /// Splits the subtree of height `height` rooted at depth `depth` (fills `m_levels`).
+            void split( int depth, int height );
+            /// Number of keys before the external node reached by the search.
+            std::size_t descend( value_type value, bool upper ) const;
+    };
+}
+
+#endif // VEB_INDEX_H
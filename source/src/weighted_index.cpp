@@ -0,0 +1,332 @@
+/*!
+ * \file weighted_index.cpp
+ * Implementation of the frequency-aware search index.
+ *
+ * \date October 19th, 2026.
+ */
+
+#include "weighted_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <queue>
+#include <utility>
+
+namespace sa {
+
+    namespace {
+        /// Threads that have looked something up so far.
+        std::atomic<unsigned> n_threads{0};
+        /// This thread's countdown in every index.
+        thread_local const unsigned thread_slot{ n_threads.fetch_add( 1, std::memory_order_relaxed ) };
+
+        /// A range of distinct keys waiting to become a subtree of the tier.
+        struct pending_t {
+            std::uint64_t weight;   //!< Total weight of its keys.
+            std::size_t first;      //!< First distinct key.
+            std::size_t last;       //!< Just past the last one.
+            std::uint32_t parent;   //!< Node to hang it from.
+            bool left;              //!< Whether it is that node's left child.
+            int depth;              //!< Depth of its root.
+
+            /// Heaviest first; ties in key order, so the layout is deterministic.
+            bool operator<( const pending_t & other ) const
+            {
+                return weight < other.weight || ( weight == other.weight && first > other.first );
+            }
+        };
+    }
+
+    const std::size_t weighted_index::default_tier_nodes;
+    const std::uint32_t weighted_index::none;
+    const std::size_t weighted_index::unknown_rank;
+    const std::size_t weighted_index::n_countdowns;
+
+    /*!
+     * Groups the range into distinct keys and lays out the tier for the given frequencies.
+     * \param first Pointer to the begining of the sorted data range.
+     * \param last Pointer just past the last element of the data range.
+     * \param weights Access frequency of each element of the range, or `nullptr` for none.
+     * \param tier_nodes Maximum number of nodes in the top tier.
+     */
+    weighted_index::weighted_index( value_type * first, value_type * last, const std::uint64_t * weights,
+                                    std::size_t tier_nodes )
+        : m_first{ first }, m_last{ last }, m_tier_nodes{ std::min<std::size_t>( tier_nodes, none ) },
+          m_countdowns{ nullptr }, m_samples{ 0 }, m_rebuild_after{ 0 }, m_sample_period{ 16 }, m_expected_probes{ 0 }
+    {
+        const std::size_t n = size();
+        std::vector<std::uint64_t> key_weights;
+        for ( std::size_t i{0} ; i < n ; ++i ) {
+            if ( i == 0 || first[i] != first[i - 1] ) {
+                m_starts.push_back( i );
+                key_weights.push_back( 0 );
+            }
+            if ( weights != nullptr ) {
+                key_weights.back() += weights[i];
+            }
+        }
+        m_starts.push_back( n );
+        m_counts = std::vector<std::atomic<std::uint32_t>>( key_weights.size() );
+        for ( std::size_t k{0} ; k < key_weights.size() ; ++k ) {
+            m_counts[k].store( static_cast<std::uint32_t>( std::min<std::uint64_t>( key_weights[k], 0xFFFFFFFFu ) ),
+                               std::memory_order_relaxed );
+        }
+        allocate_countdowns();
+        build( key_weights );
+    }
+
+    weighted_index::weighted_index( const weighted_index & other )
+        : m_first{ other.m_first }, m_last{ other.m_last }, m_tier_nodes{ other.m_tier_nodes },
+          m_starts{ other.m_starts }, m_nodes{ other.m_nodes }, m_rank{ other.m_rank },
+          m_counts( other.m_counts.size() ), m_countdowns{ nullptr },
+          m_samples{ other.m_samples.load( std::memory_order_relaxed ) }, m_rebuild_after{ other.m_rebuild_after },
+          m_sample_period{ other.m_sample_period }, m_expected_probes{ other.m_expected_probes }
+    {
+        for ( std::size_t k{0} ; k < m_counts.size() ; ++k ) {
+            m_counts[k].store( other.m_counts[k].load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        }
+        // `m_countdowns` points into the storage, so the copy needs its own, aligned on its own.
+        allocate_countdowns();
+        for ( std::size_t c{0} ; c < n_countdowns ; ++c ) {
+            m_countdowns[c].left.store( other.m_countdowns[c].left.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        }
+    }
+
+    weighted_index::weighted_index( weighted_index && other )
+        : m_first{ other.m_first }, m_last{ other.m_last }, m_tier_nodes{ other.m_tier_nodes },
+          m_starts{ std::move( other.m_starts ) }, m_nodes{ std::move( other.m_nodes ) }, m_rank{ std::move( other.m_rank ) },
+          m_counts{ std::move( other.m_counts ) }, m_countdown_storage{ std::move( other.m_countdown_storage ) },
+          m_countdowns{ other.m_countdowns }, m_samples{ other.m_samples.load( std::memory_order_relaxed ) },
+          m_rebuild_after{ other.m_rebuild_after }, m_sample_period{ other.m_sample_period },
+          m_expected_probes{ other.m_expected_probes }
+    {
+        other.m_countdowns = nullptr;
+        other.m_last = other.m_first;
+    }
+
+    weighted_index & weighted_index::operator=( weighted_index other )
+    {
+        // Swapping the vectors swaps their buffers, so each `m_countdowns` still points into its own.
+        std::swap( m_first, other.m_first );
+        std::swap( m_last, other.m_last );
+        std::swap( m_tier_nodes, other.m_tier_nodes );
+        std::swap( m_starts, other.m_starts );
+        std::swap( m_nodes, other.m_nodes );
+        std::swap( m_rank, other.m_rank );
+        std::swap( m_counts, other.m_counts );
+        std::swap( m_countdown_storage, other.m_countdown_storage );
+        std::swap( m_countdowns, other.m_countdowns );
+        m_samples.store( other.m_samples.exchange( m_samples.load( std::memory_order_relaxed ), std::memory_order_relaxed ),
+                         std::memory_order_relaxed );
+        std::swap( m_rebuild_after, other.m_rebuild_after );
+        std::swap( m_sample_period, other.m_sample_period );
+        std::swap( m_expected_probes, other.m_expected_probes );
+        return *this;
+    }
+
+    void weighted_index::allocate_countdowns( void )
+    {
+        const std::size_t line_bytes{ sizeof(countdown_t) };
+        m_countdown_storage.assign( n_countdowns * line_bytes + line_bytes, 0 );
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>( m_countdown_storage.data() );
+        std::size_t offset = ( line_bytes - address % line_bytes ) % line_bytes;
+        m_countdowns = reinterpret_cast<countdown_t *>( m_countdown_storage.data() + offset );
+        for ( std::size_t c{0} ; c < n_countdowns ; ++c ) {
+            new ( &m_countdowns[c] ) countdown_t();
+            m_countdowns[c].left.store( 0, std::memory_order_relaxed );
+        }
+    }
+
+    /*!
+     * Grows the tier heaviest range first: each range is split at the key holding its weighted
+     * midpoint, which becomes a node, and its two sides are queued as that node's children. Once
+     * the tier is full, the ranges still queued are left to `sa::lbound`.
+     * \param weights Frequency of each distinct key.
+     */
+    void weighted_index::build( const std::vector<std::uint64_t> & weights )
+    {
+        // Scale the frequencies so that they outweigh the one added to every key at least
+        // `observed_share` to one, however few lookups were sampled; shift huge ones down so that
+        // the sums stay far from overflowing.
+        const std::uint64_t observed_share{ 8 };
+        const std::size_t n_keys = weights.size();
+        double sum{0};
+        for ( std::uint64_t w : weights ) {
+            sum += static_cast<double>( w );
+        }
+        int shift{0};
+        for ( ; sum > static_cast<double>( std::uint64_t{1} << 40 ) ; sum /= 2 ) {
+            ++shift;
+        }
+        std::uint64_t total{0};
+        for ( std::uint64_t w : weights ) {
+            total += w >> shift;
+        }
+        std::uint64_t scale{1};
+        if ( total > 0 ) {
+            scale = std::max<std::uint64_t>( 1, ( observed_share * n_keys + total - 1 ) / total );
+            scale = std::min<std::uint64_t>( scale, ( std::uint64_t{1} << 62 ) / ( total + n_keys ) );
+        }
+        std::vector<std::uint64_t> prefix( n_keys + 1, 0 );
+        for ( std::size_t k{0} ; k < n_keys ; ++k ) {
+            prefix[k + 1] = prefix[k] + ( weights[k] >> shift ) * scale + 1;
+        }
+
+        m_nodes.clear();
+        m_rank.clear();
+        double cost{0};
+        std::priority_queue<pending_t> pending;
+        if ( n_keys > 0 ) {
+            pending.push( pending_t{ prefix[n_keys], 0, n_keys, none, false, 0 } );
+        }
+        while ( not pending.empty() ) {
+            pending_t range = pending.top();
+            pending.pop();
+            if ( m_nodes.size() >= m_tier_nodes ) {
+                // Below a tier leaf: the path so far, then a binary search of the elements left.
+                double elements = static_cast<double>( m_starts[range.last] - m_starts[range.first] );
+                cost += static_cast<double>( range.weight ) * ( range.depth + std::ceil( std::log2( elements + 1 ) ) );
+                continue;
+            }
+            std::uint64_t middle = prefix[range.first] + range.weight / 2;
+            std::size_t k = static_cast<std::size_t>( std::upper_bound( prefix.begin() + static_cast<std::ptrdiff_t>( range.first + 1 ),
+                                                                        prefix.begin() + static_cast<std::ptrdiff_t>( range.last + 1 ),
+                                                                        middle ) - prefix.begin() ) - 1;
+
+            std::uint32_t id = static_cast<std::uint32_t>( m_nodes.size() );
+            m_nodes.push_back( node_t{ m_first[ m_starts[k] ], none, none } );
+            m_rank.push_back( k );
+            if ( range.parent != none ) {
+                ( range.left ? m_nodes[range.parent].left : m_nodes[range.parent].right ) = id;
+            }
+            cost += static_cast<double>( prefix[k + 1] - prefix[k] ) * ( range.depth + 1 );
+            if ( k > range.first ) {
+                pending.push( pending_t{ prefix[k] - prefix[range.first], range.first, k, id, true, range.depth + 1 } );
+            }
+            if ( k + 1 < range.last ) {
+                pending.push( pending_t{ prefix[range.last] - prefix[k + 1], k + 1, range.last, id, false, range.depth + 1 } );
+            }
+        }
+        m_expected_probes = n_keys > 0 ? cost / static_cast<double>( prefix[n_keys] ) : 0;
+    }
+
+    /*!
+     * Walks the tier; on a miss, the last nodes passed on either side bound the elements left.
+     * \param value The value we are looking for.
+     * \param rank Set to the distinct key of the node hit, or `unknown_rank`.
+     * \return The lower bound of `value` in the original range.
+     */
+    value_type * weighted_index::locate( value_type value, std::size_t & rank ) const
+    {
+        std::uint32_t node = m_nodes.empty() ? none : 0;
+        std::uint32_t right_of{ none }, left_of{ none };
+        while ( node != none ) {
+            const node_t & x = m_nodes[node];
+            if ( value < x.key ) {
+                left_of = node;
+                node = x.left;
+            }
+            else if ( x.key < value ) {
+                right_of = node;
+                node = x.right;
+            }
+            else {
+                rank = m_rank[node];
+                return m_first + m_starts[rank];
+            }
+        }
+        rank = unknown_rank;
+        std::size_t low = right_of == none ? 0 : m_starts[ m_rank[right_of] + 1 ];
+        std::size_t high = left_of == none ? size() : m_starts[ m_rank[left_of] ];
+        return sa::lbound( m_first + low, m_first + high, value );
+    }
+
+    /*!
+     * Counts one lookup in every `sample_period()` of this thread, and rebuilds once enough have
+     * been counted, if asked to.
+     * \param result Where the lookup landed.
+     * \param rank Its distinct key, or `unknown_rank`.
+     */
+    void weighted_index::sample( value_type * result, std::size_t rank )
+    {
+        if ( m_sample_period == 0 || result == m_last ) {
+            return;
+        }
+        // Each thread has its own countdown in each index (so indexes do not use up each other's
+        // samples); plain loads and stores suffice, as only the rare threads sharing a slot race.
+        std::atomic<unsigned> & countdown = m_countdowns[ thread_slot % n_countdowns ].left;
+        const unsigned left = countdown.load( std::memory_order_relaxed );
+        if ( left > 0 ) {
+            countdown.store( left - 1, std::memory_order_relaxed );
+            return;
+        }
+        countdown.store( m_sample_period - 1, std::memory_order_relaxed );
+        if ( rank == unknown_rank ) {
+            std::size_t position = static_cast<std::size_t>( result - m_first );
+            rank = static_cast<std::size_t>( std::upper_bound( m_starts.begin(), m_starts.end(), position ) - m_starts.begin() ) - 1;
+        }
+        if ( m_counts[rank].load( std::memory_order_relaxed ) != 0xFFFFFFFFu ) {
+            m_counts[rank].fetch_add( 1, std::memory_order_relaxed );
+        }
+        if ( m_samples.fetch_add( 1, std::memory_order_relaxed ) + 1 == m_rebuild_after ) {
+            rebuild();
+        }
+    }
+
+    /*!
+     * Finds the lower bound of a value.
+     * \param value The value we are looking for.
+     * \return A pointer to the first element not less than `value`, or `last` if there is none.
+     */
+    value_type * weighted_index::lbound( value_type value )
+    {
+        std::size_t rank;
+        value_type * result = locate( value, rank );
+        sample( result, rank );
+        return result;
+    }
+
+    /*!
+     * Looks for a value; only hits are counted.
+     * \param value The value we are looking for.
+     * \return A pointer to the first element equal to `value`, or `last` if there is none.
+     */
+    value_type * weighted_index::bsearch( value_type value )
+    {
+        std::size_t rank;
+        value_type * result = locate( value, rank );
+        if ( result == m_last || *result != value ) {
+            return m_last;
+        }
+        sample( result, rank );
+        return result;
+    }
+
+    /*!
+     * Lays the tier out again for the lookups sampled so far, then halves the counters so that
+     * older lookups weigh less and less against newer ones.
+     */
+    void weighted_index::rebuild( void )
+    {
+        std::vector<std::uint64_t> weights( m_counts.size() );
+        for ( std::size_t k{0} ; k < m_counts.size() ; ++k ) {
+            std::uint32_t count = m_counts[k].load( std::memory_order_relaxed );
+            weights[k] = count;
+            m_counts[k].store( count / 2, std::memory_order_relaxed );
+        }
+        m_samples.store( 0, std::memory_order_relaxed );
+        build( weights );
+    }
+
+    /*!
+     * Memory used by the index.
+     * \return Bytes used by the tier, the key boundaries and the counters.
+     */
+    std::size_t weighted_index::memory_bytes( void ) const
+    {
+        return m_nodes.size() * sizeof(node_t) + m_rank.size() * sizeof(std::size_t)
+             + m_starts.size() * sizeof(std::size_t) + m_counts.size() * sizeof(std::atomic<std::uint32_t>)
+             + m_countdown_storage.size();
+    }
+}
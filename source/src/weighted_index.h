@@ -0,0 +1,128 @@
+/*!
+ * \file weighted_index.h
+ * Search over a sorted array laid out for a skewed, known or observed, query distribution.
+ *
+ * \date October 19th, 2026.
+ */
+
+#ifndef WEIGHTED_INDEX_H
+#define WEIGHTED_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "searching.h"
+
+namespace sa {
+
+    /*!
+     * A weight-balanced search tree over the distinct keys of a sorted range, truncated to a
+     * compact top tier that stays cache resident.
+     *
+     * Each node splits the weight of its keys in half (Mehlhorn's rule, within a factor of the
+     * optimal expected cost), and the tier is grown heaviest subtree first, so hot keys sit near
+     * the root and are found in a few probes while cold ones fall through to `sa::lbound` on the
+     * short sub-range below a tier leaf. Every key also weighs one (frequencies are scaled to outweigh
+     * these eightfold), so keys never seen are still split evenly, as by a plain binary search.
+     *
+     * Frequencies can be given up front and are also sampled from the lookups themselves (one in
+     * `sample_period()` per thread); `rebuild()` rebuilds the tier from those live counters and
+     * halves them, so the layout follows a drifting workload. The frequencies given up front seed
+     * the counters, so they carry over into rebuilds and fade like any other count.
+     *
+     * \note The original range must outlive the index, since results point into it.
+     * \note Lookups may run concurrently; `rebuild()` (and automatic rebuilding) may not.
+     */
+    class weighted_index {
+        public:
+            /// Default number of nodes in the top tier (48 KiB).
+            static const std::size_t default_tier_nodes{ 4096 };
+
+            /*!
+             * Builds the index of the sorted range `[first,last)`; `weights`, if given, holds the
+             * access frequency of each element (those of equal elements are summed).
+             */
+            weighted_index( value_type * first, value_type * last, const std::uint64_t * weights = nullptr,
+                            std::size_t tier_nodes = default_tier_nodes );
+            weighted_index( const weighted_index & other );
+            weighted_index( weighted_index && other );
+            weighted_index & operator=( weighted_index other );
+
+            /// Lower bound of `value`, as a pointer into the original range.
+            value_type * lbound( value_type value );
+
+            /// First occurrence of `value` in the original range, or its `last` if there is none.
+            value_type * bsearch( value_type value );
+
+            /// Rebuilds the tier from the sampled counters, then halves them.
+            void rebuild( void );
+
+            /// Records one lookup in every `period` (per thread); 0 turns sampling off. Defaults to 16.
+            void set_sample_period( unsigned period ) { m_sample_period = period; }
+
+            /// The current sampling period.
+            unsigned sample_period( void ) const { return m_sample_period; }
+
+            /// Rebuilds automatically after `samples` sampled lookups; 0 (the default) never does. Single-threaded use only.
+            void set_rebuild_after( std::uint64_t samples ) { m_rebuild_after = samples; }
+
+            /// Expected number of key comparisons per lookup under the weights the tier was built from.
+            double expected_probes( void ) const { return m_expected_probes; }
+
+            /// Number of nodes in the top tier.
+            std::size_t tier_size( void ) const { return m_nodes.size(); }
+
+            /// Number of keys indexed.
+            std::size_t size( void ) const { return static_cast<std::size_t>( m_last - m_first ); }
+
+            /// Bytes used by the index, counters included.
+            std::size_t memory_bytes( void ) const;
+
+        private:
+            /// A node of the top tier; children are node numbers, or `none`.
+            struct node_t {
+                value_type key;
+                std::uint32_t left;
+                std::uint32_t right;
+            };
+            static const std::uint32_t none{ 0xFFFFFFFFu };
+            /// Sampling countdowns per index; threads beyond this many share them.
+            static const std::size_t n_countdowns{ 64 };
+
+            /// The sampling countdown of one thread; `m_countdowns` aligns them, so each has a cache line to itself.
+            struct countdown_t {
+                std::atomic<unsigned> left;
+                char padding[64 - sizeof(std::atomic<unsigned>)];
+            };
+            static_assert( sizeof(countdown_t) == 64, "a countdown must fill exactly one cache line" );
+
+            static const std::size_t unknown_rank{ ~std::size_t{0} };
+
+            /// Lower bound of `value`; `rank` is set to its distinct key if a node was hit, `unknown_rank` otherwise.
+            value_type * locate( value_type value, std::size_t & rank ) const;
+            /// Counts a lookup that landed on `result` (distinct key `rank`, if known), if this one is sampled.
+            void sample( value_type * result, std::size_t rank );
+            /// Lays out the tier for the given per-distinct-key weights.
+            void build( const std::vector<std::uint64_t> & weights );
+            /// Allocates `n_countdowns` zeroed countdowns and points `m_countdowns` at the first one.
+            void allocate_countdowns( void );
+
+            value_type * m_first;                          //!< The original range.
+            value_type * m_last;                           //!< Just past its end.
+            std::size_t m_tier_nodes;                      //!< Capacity of the tier.
+            std::vector<std::size_t> m_starts;             //!< First position of each distinct key, then `size()`.
+            std::vector<node_t> m_nodes;                   //!< The tier, heaviest nodes first.
+            std::vector<std::size_t> m_rank;               //!< Distinct key of each node.
+            std::vector<std::atomic<std::uint32_t>> m_counts; //!< Sampled lookups per distinct key.
+            std::vector<unsigned char> m_countdown_storage; //!< Backing storage, with room to align the countdowns.
+            countdown_t * m_countdowns;                    //!< Lookups left before each thread samples one, aligned to a cache line.
+            std::atomic<std::uint64_t> m_samples;          //!< Sampled lookups since the last rebuild.
+            std::uint64_t m_rebuild_after;                 //!< Automatic rebuild threshold (0 = never).
+            unsigned m_sample_period;                      //!< One lookup in this many is counted.
+            double m_expected_probes;                      //!< Cost model of the current tier.
+    };
+}
+
+#endif // WEIGHTED_INDEX_H
@@ -8,10 +8,38 @@
 #include <random>     // random_device, mt19937
 #include <iterator>   // std::begin(), std::end()
 #include <algorithm>
+#include <vector>
+#include <memory>     // std::unique_ptr
+#include <utility>
+#include <string>
+#include <limits>
+#include <cstdio>     // std::remove()
+#include <stdexcept>  // std::runtime_error
+#include <system_error>
+#include <cstdlib>    // std::llabs()
+#include <thread>
 
 #include "include/tm/test_manager.h"
 
 #include "../src/searching.h"
+#include "../src/searcher.h"
+#include "../src/hash_index.h"
+#include "../src/bloom_filter.h"
+#include "../src/result_cache.h"
+#include "../src/composite.h"
+#include "../src/string_index.h"
+#include "../src/kary_search.h"
+#include "../src/disk_index.h"
+#include "../src/numa.h"
+#include "../src/nearest.h"
+#include "../src/veb_index.h"
+#include "../src/sorting.h"
+#include "../src/cascade.h"
+#include "../src/latency.h"
+#include "../src/segmented.h"
+#include "../src/cracking.h"
+#include "../src/weighted_index.h"
+#include "../src/set_ops.h"
 using namespace sa;
 
 int main ( void )
@@ -640,5 +668,1573 @@ int main ( void )
     tm4.summary();
     std::cout << std::endl;
 
+    // Creates a test manager for the adaptive searcher.
+    TestManager tm5{ "Adaptive Searcher Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm5, "SortedMatchesBsearch", "Every query on a sorted array finds the same key as bsearch." );
+        // DISABLE();
+        std::vector<value_type> A( 1000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = 3 * static_cast<value_type>( i );
+        searcher s{ A.data(), A.data() + A.size() };
+
+        EXPECT_TRUE( s.profile().sorted );
+        for ( value_type v{-2} ; v < 3003 ; ++v )
+        {
+            auto expected = bsearch( A.data(), A.data() + A.size(), v );
+            auto result = s.find( v );
+            EXPECT_EQ( result, expected );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm5, "UnsortedUsesScans", "An unsorted array is only searched by scanning strategies." );
+        // DISABLE();
+        value_type A[]{ 9, 4, 7, 1, 8, 2, 6, 3, 5 };
+        searcher s{ std::begin(A), std::end(A) };
+
+        EXPECT_FALSE( s.profile().sorted );
+        EXPECT_TRUE( ( s.decision().single == searcher::strategy_t::LINEAR || s.decision().single == searcher::strategy_t::SCAN ) );
+        EXPECT_TRUE( ( s.decision().batch == searcher::strategy_t::LINEAR || s.decision().batch == searcher::strategy_t::SCAN ) );
+        EXPECT_LT( s.decision().latency_ns[ static_cast<size_t>( searcher::strategy_t::BINARY ) ], 0 );
+        for ( const auto & e : A )
+        {
+            EXPECT_EQ( *s.find( e ), e );
+        }
+        EXPECT_EQ( s.find( 10 ), std::end(A) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm5, "EveryStrategyAgrees", "Each strategy gives a correct result on a sorted array with repetitions." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 9, 12, 40 };
+        searcher s{ std::begin(A), std::end(A) };
+
+        for ( size_t st{0} ; st < searcher::n_strategies ; ++st )
+        {
+            for ( value_type v{-1} ; v < 42 ; ++v )
+            {
+                auto result = s.find_with( static_cast<searcher::strategy_t>( st ), v );
+                bool present = std::binary_search( std::begin(A), std::end(A), v );
+                EXPECT_EQ( ( result != std::end(A) ), present );
+                if ( present ) EXPECT_EQ( *result, v );
+            }
+        }
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm5, "BatchSearch", "Batch results match single queries." );
+        // DISABLE();
+        std::vector<value_type> A( 5000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i * i % 7919 );
+        std::sort( A.begin(), A.end() );
+        searcher s{ A.data(), A.data() + A.size() };
+
+        std::vector<value_type> Q{ -1, 0, 1, 4, 7918, 7919, 100, 3000 };
+        std::vector<value_type*> R( Q.size() );
+        s.find( Q.data(), Q.data() + Q.size(), R.data() );
+        for ( size_t i{0} ; i < Q.size() ; ++i )
+        {
+            bool present = std::binary_search( A.begin(), A.end(), Q[i] );
+            EXPECT_EQ( ( R[i] != A.data() + A.size() ), present );
+            if ( present ) EXPECT_EQ( *R[i], Q[i] );
+        }
+    }
+
+    {
+        //=== Test #5
+        BEGIN_TEST(tm5, "EmptyRange", "A searcher over an empty range finds nothing." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5 };
+        searcher s{ std::begin(A), std::begin(A) };
+
+        EXPECT_EQ( s.profile().size, 0u );
+        EXPECT_EQ( s.find( 3 ), std::begin(A) );
+        EXPECT_FALSE( s.describe().empty() );
+    }
+
+    tm5.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the galloping searches.
+    TestManager tm6{ "Exponential Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm6, "ExpBoundsMatchStd", "Exponential lower/upper bounds agree with the STL for every target." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 8, 13, 21, 34 };
+
+        for ( value_type v{-1} ; v < 36 ; ++v )
+        {
+            EXPECT_EQ( exp_lbound( std::begin(A), std::end(A), v ), std::lower_bound( std::begin(A), std::end(A), v ) );
+            EXPECT_EQ( exp_ubound( std::begin(A), std::end(A), v ), std::upper_bound( std::begin(A), std::end(A), v ) );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm6, "ExpBsearch", "Exponential binary search finds present elements and misses absent ones." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11 };
+
+        for ( const auto & e : A )
+        {
+            auto result = exp_bsearch( std::begin(A), std::end(A), e );
+            EXPECT_EQ( *result, e );
+        }
+        for ( auto i{0} ; i < 13 ; i+=2 )
+        {
+            EXPECT_EQ( exp_bsearch( std::begin(A), std::end(A), i ), std::end(A) );
+        }
+        EXPECT_EQ( exp_bsearch( std::begin(A), std::begin(A), 1 ), std::begin(A) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm6, "HintAnywhere", "Hinted bounds agree with the STL for every hint position, including the ends." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 8, 13, 21, 34 };
+
+        for ( auto hint = std::begin(A) ; hint <= std::end(A) ; ++hint )
+        {
+            for ( value_type v{-1} ; v < 36 ; ++v )
+            {
+                EXPECT_EQ( lbound_hint( std::begin(A), std::end(A), v, hint ), std::lower_bound( std::begin(A), std::end(A), v ) );
+                EXPECT_EQ( ubound_hint( std::begin(A), std::end(A), v, hint ), std::upper_bound( std::begin(A), std::end(A), v ) );
+            }
+        }
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm6, "CursorSweep", "Feeding the previous result as hint walks a large array correctly." );
+        // DISABLE();
+        std::vector<value_type> A( 10000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i / 3 );
+
+        auto cursor = A.data();
+        for ( value_type v{0} ; v < 3400 ; v += 7 )
+        {
+            cursor = lbound_hint( A.data(), A.data() + A.size(), v, cursor );
+            EXPECT_EQ( cursor, std::lower_bound( A.data(), A.data() + A.size(), v ) );
+        }
+    }
+
+    {
+        //=== Test #5
+        BEGIN_TEST(tm6, "EmptyRange", "Galloping over an empty range returns last." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5 };
+
+        EXPECT_EQ( exp_lbound( std::begin(A), std::begin(A), 3 ), std::begin(A) );
+        EXPECT_EQ( lbound_hint( std::begin(A), std::begin(A), 3, std::end(A) ), std::begin(A) );
+    }
+
+    tm6.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the hash index.
+    TestManager tm7{ "Hash Index Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm7, "MatchesBsearch", "Both layouts return the same pointer as bsearch on a sorted array of distinct keys." );
+        // DISABLE();
+        std::vector<value_type> A( 3000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = 5 * static_cast<value_type>( i ) - 7000;
+        hash_index open{ A.data(), A.data() + A.size() };
+        hash_index perfect{ A.data(), A.data() + A.size(), hash_index::layout_t::PERFECT };
+
+        EXPECT_EQ( open.size(), A.size() );
+        EXPECT_EQ( perfect.size(), A.size() );
+        for ( value_type v{-7010} ; v < 8010 ; ++v )
+        {
+            auto expected = bsearch( A.data(), A.data() + A.size(), v );
+            EXPECT_EQ( open.find( v ), expected );
+            EXPECT_EQ( perfect.find( v ), expected );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm7, "UnsortedWithRepetitions", "Keys are found in unsorted ranges, pointing to their first occurrence." );
+        // DISABLE();
+        value_type A[]{ 7, 3, 7, -1, 3, 0, 42, 0, 7 };
+
+        for ( auto layout : { hash_index::layout_t::OPEN_ADDRESSING, hash_index::layout_t::PERFECT } )
+        {
+            hash_index index{ std::begin(A), std::end(A), layout };
+            EXPECT_EQ( index.size(), 5u );
+            for ( const auto & e : A )
+            {
+                EXPECT_EQ( index.find( e ), std::find( std::begin(A), std::end(A), e ) );
+            }
+            EXPECT_EQ( index.find( 1 ), std::end(A) );
+            EXPECT_FALSE( index.contains( 8 ) );
+        }
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm7, "BatchLookup", "Batch lookups match single lookups." );
+        // DISABLE();
+        value_type A[]{ 2, 4, 6, 8, 10, 12 };
+        hash_index index{ std::begin(A), std::end(A), hash_index::layout_t::PERFECT };
+
+        value_type Q[]{ 1, 2, 6, 7, 12, 13 };
+        value_type* R[6];
+        index.find( std::begin(Q), std::end(Q), R );
+        for ( size_t i{0} ; i < 6 ; ++i )
+        {
+            EXPECT_EQ( R[i], index.find( Q[i] ) );
+        }
+        EXPECT_EQ( R[1], std::begin(A) );
+        EXPECT_EQ( R[3], std::end(A) );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm7, "EmptyRange", "An index over an empty range finds nothing." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5 };
+
+        hash_index open{ std::begin(A), std::begin(A) };
+        hash_index perfect{ std::begin(A), std::begin(A), hash_index::layout_t::PERFECT };
+        EXPECT_EQ( open.find( 1 ), std::begin(A) );
+        EXPECT_EQ( perfect.find( 1 ), std::begin(A) );
+    }
+
+    tm7.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the Bloom filter front.
+    TestManager tm8{ "Blocked Bloom Filter Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm8, "NoFalseNegatives", "Every key the filter was built with is reported as possibly present." );
+        // DISABLE();
+        std::vector<value_type> A( 20000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = 2 * static_cast<value_type>( i );
+        blocked_bloom filter{ A.data(), A.data() + A.size() };
+
+        for ( const auto & e : A )
+        {
+            EXPECT_TRUE( filter.may_contain( e ) );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm8, "FalsePositiveRate", "Absent keys are rejected at about the requested rate." );
+        // DISABLE();
+        std::vector<value_type> A( 20000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = 2 * static_cast<value_type>( i );
+        blocked_bloom filter{ A.data(), A.data() + A.size(), 0.01 };
+
+        size_t false_positives{0};
+        for ( size_t i{0} ; i < A.size() ; ++i )
+        {
+            false_positives += filter.may_contain( 2 * static_cast<value_type>( i ) + 1 );
+        }
+        EXPECT_LT( false_positives, A.size() * 3 / 100 );
+        EXPECT_LT( filter.expected_fp_rate(), 0.02 );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm8, "MemoryBudget", "The filter never exceeds its memory budget." );
+        // DISABLE();
+        std::vector<value_type> A( 20000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i );
+        blocked_bloom filter{ A.data(), A.data() + A.size(), 0.0001, 4096 };
+
+        EXPECT_LE( filter.memory_bytes(), 4096u );
+        EXPECT_GT( filter.expected_fp_rate(), 0.0001 );
+        for ( const auto & e : A )
+        {
+            EXPECT_TRUE( filter.may_contain( e ) );
+        }
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm8, "FilteredSearches", "Filtered searches give the same results as the plain ones." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5, 7, 9, 11 };
+        blocked_bloom filter{ std::begin(A), std::end(A) };
+
+        for ( value_type v{-1} ; v < 13 ; ++v )
+        {
+            EXPECT_EQ( bsearch( filter, std::begin(A), std::end(A), v ), bsearch( std::begin(A), std::end(A), v ) );
+            EXPECT_EQ( lsearch( filter, std::begin(A), std::end(A), v ), lsearch( std::begin(A), std::end(A), v ) );
+        }
+    }
+
+    {
+        //=== Test #5
+        BEGIN_TEST(tm8, "EmptyRange", "A filter over an empty range rejects everything." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5 };
+        blocked_bloom filter{ std::begin(A), std::begin(A) };
+
+        EXPECT_FALSE( filter.may_contain( 1 ) );
+        EXPECT_EQ( bsearch( filter, std::begin(A), std::begin(A), 1 ), std::begin(A) );
+    }
+
+    {
+        //=== Test #6
+        BEGIN_TEST(tm8, "CopyOutlivesSource", "Copies and moves of a filter keep answering after the source is gone." );
+        // DISABLE();
+        std::vector<value_type> A( 2000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( 3 * i );
+        std::unique_ptr<blocked_bloom> source{ new blocked_bloom{ A.data(), A.data() + A.size() } };
+        blocked_bloom copy{ *source };
+        blocked_bloom assigned{ A.data(), A.data() };
+        assigned = *source;
+        blocked_bloom moved{ blocked_bloom{ *source } };
+        const size_t bytes = source->memory_bytes();
+        source.reset();
+
+        bool all_present{true};
+        for ( value_type v : A )
+        {
+            all_present = all_present && copy.may_contain( v ) && assigned.may_contain( v ) && moved.may_contain( v );
+        }
+        EXPECT_TRUE( all_present );
+        EXPECT_EQ( copy.memory_bytes(), bytes );
+        EXPECT_EQ( assigned.memory_bytes(), bytes );
+    }
+
+    tm8.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the result cache.
+    TestManager tm9{ "Result Cache Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm9, "CachedBoundsMatch", "Cached searches return the same results as the plain ones, on first and repeated calls." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5 };
+        result_cache lb_cache, ub_cache, bs_cache;
+
+        for ( int round{0} ; round < 2 ; ++round )
+        {
+            for ( value_type v{-1} ; v < 8 ; ++v )
+            {
+                EXPECT_EQ( lbound( lb_cache, std::begin(A), std::end(A), v ), std::lower_bound( std::begin(A), std::end(A), v ) );
+                EXPECT_EQ( ubound( ub_cache, std::begin(A), std::end(A), v ), std::upper_bound( std::begin(A), std::end(A), v ) );
+                EXPECT_EQ( bsearch( bs_cache, std::begin(A), std::end(A), v ), bsearch( std::begin(A), std::end(A), v ) );
+            }
+        }
+        EXPECT_EQ( lb_cache.stats().hits, 9u );
+        EXPECT_EQ( lb_cache.stats().misses, 9u );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm9, "SkewedHitRatio", "A skewed query stream is mostly answered by the cache." );
+        // DISABLE();
+        std::vector<value_type> A( 100000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i );
+        result_cache cache{ 1024 };
+
+        // 90% of the queries go to 256 hot keys.
+        for ( value_type q{0} ; q < 20000 ; ++q )
+        {
+            value_type v = ( q % 10 == 0 ) ? ( q * 7919 ) % 100000 : ( q * 31 ) % 256;
+            auto result = lbound( cache, A.data(), A.data() + A.size(), v );
+            EXPECT_EQ( *result, v );
+        }
+        EXPECT_GT( cache.stats().hit_ratio(), 0.85 );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm9, "Eviction", "A full set evicts entries and keeps answering correctly." );
+        // DISABLE();
+        result_cache cache{ 8 };
+        std::ptrdiff_t index;
+
+        EXPECT_EQ( cache.capacity(), 8u );
+        for ( value_type k{0} ; k < 100 ; ++k ) cache.insert( k, k + 1 );
+        size_t present{0};
+        for ( value_type k{0} ; k < 100 ; ++k )
+        {
+            if ( cache.lookup( k, index ) )
+            {
+                ++present;
+                EXPECT_EQ( index, k + 1 );
+            }
+        }
+        EXPECT_EQ( present, 8u );
+
+        cache.clear();
+        EXPECT_FALSE( cache.lookup( 99, index ) );
+        cache.reset_stats();
+        EXPECT_EQ( cache.stats().hits + cache.stats().misses, 0u );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm9, "EmptyRange", "Cached searches over an empty range return last." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 5 };
+        result_cache cache;
+
+        EXPECT_EQ( lbound( cache, std::begin(A), std::begin(A), 3 ), std::begin(A) );
+        EXPECT_EQ( lbound( cache, std::begin(A), std::begin(A), 3 ), std::begin(A) );
+    }
+
+    {
+        //=== Test #5
+        BEGIN_TEST(tm9, "CopyOutlivesSource", "Copies of a cache are independent and outlive their source." );
+        // DISABLE();
+        std::unique_ptr<result_cache> source{ new result_cache{ 64 } };
+        for ( value_type k{0} ; k < 16 ; ++k ) source->insert( k, k * 2 );
+        result_cache copy{ *source };
+        result_cache assigned{ 8 };
+        assigned = *source;
+        result_cache moved{ result_cache{ *source } };
+        source->clear();
+        source.reset();
+
+        std::ptrdiff_t index{0};
+        bool all_cached{true};
+        for ( value_type k{0} ; k < 16 ; ++k )
+        {
+            all_cached = all_cached && copy.lookup( k, index ) && index == k * 2
+                                    && assigned.lookup( k, index ) && index == k * 2
+                                    && moved.lookup( k, index ) && index == k * 2;
+        }
+        EXPECT_TRUE( all_cached );
+        EXPECT_EQ( assigned.capacity(), 64u );
+
+        // Entries added to a copy do not show up in another.
+        copy.insert( 100, 7 );
+        EXPECT_TRUE( copy.lookup( 100, index ) );
+        EXPECT_FALSE( assigned.lookup( 100, index ) );
+    }
+
+    tm9.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the multi-column search.
+    TestManager tm10{ "Composite Key Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm10, "BoundsMatchPairs", "Two-column bounds agree with the STL on an array of pairs." );
+        // DISABLE();
+        std::vector< std::pair<value_type, value_type> > rows;
+        for ( value_type tenant{0} ; tenant < 6 ; ++tenant )
+            for ( value_type t{0} ; t < 4 * tenant ; t += 2 )
+                rows.push_back( std::make_pair( 2 * tenant, t ) );
+        std::vector<value_type> tenants, stamps;
+        for ( const auto & r : rows ) { tenants.push_back( r.first ); stamps.push_back( r.second ); }
+        composite_index index{ { tenants.data(), stamps.data() }, rows.size() };
+
+        for ( value_type tenant{-1} ; tenant < 12 ; ++tenant )
+        {
+            for ( value_type t{-1} ; t < 22 ; ++t )
+            {
+                value_type key[]{ tenant, t };
+                auto pair = std::make_pair( tenant, t );
+                auto expected_lb = std::lower_bound( rows.begin(), rows.end(), pair ) - rows.begin();
+                auto expected_ub = std::upper_bound( rows.begin(), rows.end(), pair ) - rows.begin();
+                EXPECT_EQ( index.lbound( key, 2 ), static_cast<size_t>( expected_lb ) );
+                EXPECT_EQ( index.ubound( key, 2 ), static_cast<size_t>( expected_ub ) );
+                auto range = index.equal_range( key, 2 );
+                EXPECT_EQ( range.first, static_cast<size_t>( expected_lb ) );
+                EXPECT_EQ( range.last, static_cast<size_t>( expected_ub ) );
+            }
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm10, "PrefixKey", "A one-component key selects all the rows of a tenant." );
+        // DISABLE();
+        value_type tenants[]{ 1, 1, 1, 3, 3, 7 };
+        value_type stamps[] { 5, 6, 9, 1, 2, 0 };
+        composite_index index{ { tenants, stamps }, 6 };
+
+        value_type key[]{ 3 };
+        auto range = index.equal_range( key, 1 );
+        EXPECT_EQ( range.first, 3u );
+        EXPECT_EQ( range.last, 5u );
+        key[0] = 2;
+        EXPECT_EQ( index.lbound( key, 1 ), 3u );
+        EXPECT_EQ( index.ubound( key, 1 ), 3u );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm10, "BatchMatchesSingle", "Batch searches match single searches, in any query order." );
+        // DISABLE();
+        value_type tenants[]{ 1, 1, 1, 3, 3, 3, 3, 7, 7, 9 };
+        value_type stamps[] { 5, 6, 9, 1, 2, 2, 8, 0, 4, 4 };
+        composite_index index{ { tenants, stamps }, 10 };
+
+        value_type keys[]{ 3, 2,  1, 6,  9, 4,  0, 0,  7, 3,  3, 9,  10, 0,  3, 2 };
+        row_range ranges[8];
+        size_t lbs[8], ubs[8];
+        index.equal_range( keys, 2, 8, ranges );
+        index.lbound( keys, 2, 8, lbs );
+        index.ubound( keys, 2, 8, ubs );
+        for ( size_t q{0} ; q < 8 ; ++q )
+        {
+            auto range = index.equal_range( keys + 2 * q, 2 );
+            EXPECT_EQ( ranges[q].first, range.first );
+            EXPECT_EQ( ranges[q].last, range.last );
+            EXPECT_EQ( lbs[q], index.lbound( keys + 2 * q, 2 ) );
+            EXPECT_EQ( ubs[q], index.ubound( keys + 2 * q, 2 ) );
+        }
+        EXPECT_EQ( ranges[0].first, 4u );
+        EXPECT_EQ( ranges[0].last, 6u );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm10, "NoRows", "Searching a table without rows returns empty ranges." );
+        // DISABLE();
+        value_type tenants[]{ 1 };
+        value_type stamps[] { 1 };
+        composite_index index{ { tenants, stamps }, 0 };
+
+        value_type key[]{ 1, 1 };
+        EXPECT_EQ( index.lbound( key, 2 ), 0u );
+        EXPECT_EQ( index.equal_range( key, 2 ).last, 0u );
+    }
+
+    tm10.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the string index.
+    TestManager tm11{ "String Index Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm11, "BoundsMatchStd", "String bounds agree with the STL, including keys sharing long prefixes." );
+        // DISABLE();
+        std::vector<std::string> keys{ "host-a.example.com", "host-b.example.com", "host-a.example.org", "hos",
+                                       "ho", "", "SKU-0001", "SKU-0002", "SKU-0002", "SKU-00021", "zzzz", "zzzzz" };
+        string_index index{ keys };
+        std::sort( keys.begin(), keys.end() );
+
+        std::vector<std::string> probes( keys );
+        probes.insert( probes.end(), { "a", "host", "host-a", "host-a.example.net", "SKU-0000", "SKU-00020", "zzz", "zzzzzz", "~" } );
+        for ( const auto & p : probes )
+        {
+            EXPECT_EQ( index.lbound( p ), static_cast<size_t>( std::lower_bound( keys.begin(), keys.end(), p ) - keys.begin() ) );
+            EXPECT_EQ( index.ubound( p ), static_cast<size_t>( std::upper_bound( keys.begin(), keys.end(), p ) - keys.begin() ) );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm11, "Find", "Present keys are found and rebuilt from the index; absent keys are not." );
+        // DISABLE();
+        std::vector<std::string> keys{ "beta", "alpha", "alphabet", "al", "gamma" };
+        string_index index{ keys };
+
+        for ( const auto & k : keys )
+        {
+            auto pos = index.find( k );
+            EXPECT_NE( pos, index.size() );
+            EXPECT_EQ( index.key( pos ), k );
+        }
+        EXPECT_EQ( index.find( "alph" ), index.size() );
+        EXPECT_EQ( index.find( "alphabets" ), index.size() );
+        EXPECT_EQ( index.find( "" ), index.size() );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm11, "EmbeddedZeros", "Short keys padded with zeros are told apart from keys holding zero bytes." );
+        // DISABLE();
+        std::vector<std::string> keys{ std::string( "a" ), std::string( "a\0", 2 ), std::string( "a\0\0\0", 4 ), std::string( "a\0\0\0x", 5 ) };
+        string_index index{ keys };
+
+        for ( size_t i{0} ; i < keys.size() ; ++i )
+        {
+            EXPECT_EQ( index.find( keys[i] ), i );
+            EXPECT_EQ( index.key( i ), keys[i] );
+        }
+        EXPECT_EQ( index.find( std::string( "a\0\0", 3 ) ), index.size() );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm11, "EmptyIndex", "An empty index finds nothing." );
+        // DISABLE();
+        string_index index{ std::vector<std::string>{} };
+
+        EXPECT_EQ( index.size(), 0u );
+        EXPECT_EQ( index.lbound( "x" ), 0u );
+        EXPECT_EQ( index.find( "x" ), 0u );
+    }
+
+    tm11.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the k-ary search.
+    TestManager tm12{ "K-ary Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm12, "BoundsMatchStd", "K-ary lower/upper bounds agree with the STL on a large array with repetitions." );
+        // DISABLE();
+        std::vector<value_type> A( 50000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i / 3 ) * 2;
+
+        for ( value_type v{-3} ; v < 33340 ; v += 1 )
+        {
+            EXPECT_EQ( kary_lbound( A.data(), A.data() + A.size(), v ), std::lower_bound( A.data(), A.data() + A.size(), v ) );
+            EXPECT_EQ( kary_ubound( A.data(), A.data() + A.size(), v ), std::upper_bound( A.data(), A.data() + A.size(), v ) );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm12, "BsearchAnyLength", "K-ary binary search finds every element and misses absent ones, for every range length." );
+        // DISABLE();
+        std::vector<value_type> A( 300 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = 2 * static_cast<value_type>( i ) + 1;
+
+        for ( size_t n{0} ; n <= A.size() ; n += 13 )
+        {
+            for ( value_type v{0} ; v < 602 ; ++v )
+            {
+                EXPECT_EQ( kary_bsearch( A.data(), A.data() + n, v ), bsearch( A.data(), A.data() + n, v ) );
+            }
+        }
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm12, "ExtremeValues", "Keys at the limits of value_type are handled." );
+        // DISABLE();
+        std::vector<value_type> A( 1000, std::numeric_limits<value_type>::max() );
+        std::fill( A.begin(), A.begin() + 500, std::numeric_limits<value_type>::min() );
+
+        auto min = std::numeric_limits<value_type>::min();
+        auto max = std::numeric_limits<value_type>::max();
+        EXPECT_EQ( kary_lbound( A.data(), A.data() + A.size(), min ), A.data() );
+        EXPECT_EQ( kary_ubound( A.data(), A.data() + A.size(), min ), A.data() + 500 );
+        EXPECT_EQ( kary_lbound( A.data(), A.data() + A.size(), max ), A.data() + 500 );
+        EXPECT_EQ( kary_ubound( A.data(), A.data() + A.size(), max ), A.data() + A.size() );
+        EXPECT_EQ( kary_bsearch( A.data(), A.data() + A.size(), 0 ), A.data() + A.size() );
+        EXPECT_FALSE( std::string( kary_isa() ).empty() );
+    }
+
+    tm12.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the external-memory search.
+    TestManager tm13{ "Disk Index Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm13, "BothBackendsMatchStd", "Single and batch searches on a file agree with the STL, with either backend." );
+        // DISABLE();
+        std::vector<value_type> A( 100000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i / 2 ) * 3;
+        const std::string path{ "sa_disk_index_test.bin" };
+        disk_index::write( path, A.data(), A.data() + A.size() );
+
+        std::vector<value_type> Q;
+        for ( value_type v{-5} ; v < 150010 ; v += 37 ) Q.push_back( v );
+        std::shuffle( Q.begin(), Q.end(), std::mt19937{ 7 } );
+
+        for ( auto backend : { disk_index::io_backend_t::IO_URING, disk_index::io_backend_t::PREAD } )
+        {
+            disk_index index{ path, backend, 4096, 64, 4 };
+            EXPECT_EQ( index.size(), A.size() );
+
+            std::vector<std::uint64_t> lbs( Q.size() ), finds( Q.size() );
+            index.lbound( Q.data(), Q.data() + Q.size(), lbs.data() );
+            index.find( Q.data(), Q.data() + Q.size(), finds.data() );
+            for ( size_t q{0} ; q < Q.size() ; ++q )
+            {
+                auto expected = static_cast<std::uint64_t>( std::lower_bound( A.begin(), A.end(), Q[q] ) - A.begin() );
+                bool present = expected < A.size() && A[expected] == Q[q];
+                EXPECT_EQ( lbs[q], expected );
+                EXPECT_EQ( finds[q], present ? expected : A.size() );
+                EXPECT_EQ( index.lbound( Q[q] ), expected );
+            }
+        }
+        std::remove( path.c_str() );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm13, "BlockBoundaries", "Keys straddling block boundaries, and a partial last block, are handled." );
+        // DISABLE();
+        std::vector<value_type> A( 1000, 5 );
+        for ( size_t i{500} ; i < A.size() ; ++i ) A[i] = 9 + static_cast<value_type>( i % 3 == 0 );
+        std::sort( A.begin(), A.end() );
+        const std::string path{ "sa_disk_index_test.bin" };
+        disk_index::write( path, A.data(), A.data() + A.size() );
+
+        disk_index index{ path, disk_index::io_backend_t::AUTO, 64 };
+        value_type Q[]{ 4, 5, 6, 9, 10, 11 };
+        std::uint64_t R[6];
+        index.find( std::begin(Q), std::end(Q), R );
+        EXPECT_EQ( R[0], A.size() );
+        EXPECT_EQ( R[1], 0u );
+        EXPECT_EQ( R[2], A.size() );
+        EXPECT_EQ( R[3], static_cast<std::uint64_t>( std::lower_bound( A.begin(), A.end(), 9 ) - A.begin() ) );
+        EXPECT_EQ( R[4], static_cast<std::uint64_t>( std::lower_bound( A.begin(), A.end(), 10 ) - A.begin() ) );
+        EXPECT_EQ( R[5], A.size() );
+        EXPECT_EQ( index.lbound( 11 ), A.size() );
+        std::remove( path.c_str() );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm13, "MissingFile", "Opening a missing file throws." );
+        // DISABLE();
+        bool thrown{false};
+        try { disk_index index{ "sa_no_such_file.bin" }; }
+        catch ( const std::system_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+    }
+
+    tm13.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the NUMA replicas.
+    TestManager tm14{ "NUMA Replicas Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm14, "OneReplicaPerNode", "A replica is made for every online node, and each holds a copy of the range." );
+        // DISABLE();
+        std::vector<value_type> A( 10000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i ) * 2;
+        numa_replicas replicas{ A.data(), A.data() + A.size() };
+
+        EXPECT_EQ( replicas.n_replicas(), numa_nodes().size() );
+        for ( int node : numa_nodes() )
+        {
+            EXPECT_NE( replicas.replica( node ), A.data() );
+            EXPECT_TRUE( std::equal( A.begin(), A.end(), replicas.replica( node ) ) );
+            if ( replicas.bound() ) EXPECT_EQ( numa_node_of( replicas.replica( node ) ), node );
+        }
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm14, "ResultsPointIntoOriginal", "Searches on the local replica return pointers into the original range." );
+        // DISABLE();
+        value_type A[]{ 1, 1, 1, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5 };
+        numa_replicas replicas{ std::begin(A), std::end(A) };
+
+        for ( value_type v{-1} ; v < 8 ; ++v )
+        {
+            EXPECT_EQ( replicas.lbound( v ), std::lower_bound( std::begin(A), std::end(A), v ) );
+            EXPECT_EQ( replicas.ubound( v ), std::upper_bound( std::begin(A), std::end(A), v ) );
+            EXPECT_EQ( replicas.bsearch( v ), bsearch( std::begin(A), std::end(A), v ) );
+        }
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm14, "Pinning", "A thread can be pinned to its current node, and stays there." );
+        // DISABLE();
+        int node = current_numa_node();
+
+        EXPECT_FALSE( numa_node_cpus( node ).empty() );
+        EXPECT_TRUE( pin_to_numa_node( node ) );
+        EXPECT_EQ( current_numa_node(), node );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm14, "PerNodeIndexes", "An index is built over every replica, and its results map back to the original range." );
+        // DISABLE();
+        std::vector<value_type> A( 10000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i / 3 ) * 2;
+        numa_replicas replicas{ A.data(), A.data() + A.size() };
+        numa_indexes<veb_index> indexes{ replicas, []( value_type * first, value_type * last ) {
+            return std::unique_ptr<veb_index>( new veb_index( first, last ) );
+        } };
+
+        EXPECT_EQ( indexes.n_indexes(), replicas.n_replicas() );
+        for ( value_type v{-3} ; v < 6700 ; v += 7 )
+        {
+            value_type * result = indexes.local().lbound( v );
+            EXPECT_NE( result, std::lower_bound( A.begin(), A.end(), v ) - A.begin() + A.data() );
+            EXPECT_EQ( replicas.original( result ), std::lower_bound( A.begin(), A.end(), v ) - A.begin() + A.data() );
+        }
+
+        bool thrown{ false };
+        try { replicas.for_each_node( []( size_t, int, value_type *, value_type * ) { throw std::runtime_error( "task" ); } ); }
+        catch ( const std::runtime_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+    }
+
+    tm14.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the nearest-value queries.
+    TestManager tm15{ "Nearest Value Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm15, "PredecessorSuccessor", "Predecessor and successor are the strict neighbours of a value." );
+        // DISABLE();
+        value_type A[]{ 1, 3, 3, 3, 7, 9, 9, 12 };
+        auto first = std::begin(A), last = std::end(A);
+
+        EXPECT_EQ( predecessor( first, last, 1 ), last );
+        EXPECT_EQ( predecessor( first, last, 3 ), first );
+        EXPECT_EQ( predecessor( first, last, 4 ), first + 3 );
+        EXPECT_EQ( predecessor( first, last, 100 ), first + 7 );
+        EXPECT_EQ( successor( first, last, 0 ), first );
+        EXPECT_EQ( successor( first, last, 3 ), first + 4 );
+        EXPECT_EQ( successor( first, last, 12 ), last );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm15, "Nearest", "The closest element is found, the smaller one on ties, without overflowing." );
+        // DISABLE();
+        value_type A[]{ std::numeric_limits<value_type>::min(), -10, 0, 10, 20, std::numeric_limits<value_type>::max() };
+        auto first = std::begin(A), last = std::end(A);
+
+        EXPECT_EQ( nearest( first, last, -4 ), first + 2 );
+        EXPECT_EQ( nearest( first, last, 5 ), first + 2 );
+        EXPECT_EQ( nearest( first, last, 6 ), first + 3 );
+        EXPECT_EQ( nearest( first, last, 10 ), first + 3 );
+        EXPECT_EQ( nearest( first, last, std::numeric_limits<value_type>::min() + 1 ), first );
+        EXPECT_EQ( nearest( first, last, std::numeric_limits<value_type>::max() - 1 ), first + 5 );
+        EXPECT_EQ( nearest( first, first, 5 ), first );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm15, "KNearest", "The k nearest elements match a brute-force selection, for every k." );
+        // DISABLE();
+        std::mt19937 rng{ 11 };
+        std::uniform_int_distribution<value_type> key( -500, 500 );
+        std::vector<value_type> A( 300 );
+        for ( auto & a : A ) a = key( rng );
+        A.front() = std::numeric_limits<value_type>::min();
+        A.back() = std::numeric_limits<value_type>::max();
+        std::sort( A.begin(), A.end() );
+        auto first = A.data(), last = A.data() + A.size();
+
+        bool all_match{true};
+        for ( value_type v : { -1000, -500, -3, 0, 1, 77, 499, 1000 } )
+        {
+            // Brute force: sort by (distance, key) and keep the first k keys.
+            std::vector< std::pair<long long, value_type> > by_distance;
+            for ( value_type a : A ) by_distance.push_back( std::make_pair( std::llabs( static_cast<long long>( a ) - v ), a ) );
+            std::sort( by_distance.begin(), by_distance.end() );
+
+            for ( size_t k{0} ; k <= A.size() + 2 ; ++k )
+            {
+                auto window = k_nearest( first, last, v, k );
+                std::vector<value_type> expected;
+                for ( size_t i{0} ; i < std::min( k, A.size() ) ; ++i ) expected.push_back( by_distance[i].second );
+                std::sort( expected.begin(), expected.end() );
+                all_match = all_match && std::vector<value_type>( window.first, window.second ) == expected;
+            }
+        }
+        EXPECT_TRUE( all_match );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm15, "Batch", "Batch queries give the same results as single queries." );
+        // DISABLE();
+        std::mt19937 rng{ 5 };
+        std::uniform_int_distribution<value_type> key( 0, 2000 );
+        std::vector<value_type> A( 1000 ), Q( 500 );
+        for ( auto & a : A ) a = key( rng );
+        for ( auto & q : Q ) q = key( rng ) - 10;
+        std::sort( A.begin(), A.end() );
+        auto first = A.data(), last = A.data() + A.size();
+
+        std::vector<value_type *> pred( Q.size() ), succ( Q.size() ), near( Q.size() );
+        std::vector< std::pair<value_type *, value_type *> > knn( Q.size() );
+        predecessor( first, last, Q.data(), Q.data() + Q.size(), pred.data() );
+        successor( first, last, Q.data(), Q.data() + Q.size(), succ.data() );
+        nearest( first, last, Q.data(), Q.data() + Q.size(), near.data() );
+        k_nearest( first, last, Q.data(), Q.data() + Q.size(), 17, knn.data() );
+
+        for ( size_t q{0} ; q < Q.size() ; ++q )
+        {
+            EXPECT_EQ( pred[q], predecessor( first, last, Q[q] ) );
+            EXPECT_EQ( succ[q], successor( first, last, Q[q] ) );
+            EXPECT_EQ( near[q], nearest( first, last, Q[q] ) );
+            EXPECT_TRUE( ( knn[q] == k_nearest( first, last, Q[q], 17 ) ) );
+        }
+    }
+
+    tm15.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the van Emde Boas layout.
+    TestManager tm16{ "van Emde Boas Layout Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm16, "EverySize", "Bounds match the STL for every size up to a few full trees." );
+        // DISABLE();
+        bool all_match{true};
+        for ( size_t n{0} ; n <= 140 ; ++n )
+        {
+            std::vector<value_type> A( n );
+            for ( size_t i{0} ; i < n ; ++i ) A[i] = static_cast<value_type>( i ) * 2;
+            auto first = A.data(), last = A.data() + n;
+            veb_index index{ first, last };
+
+            for ( value_type v{-1} ; v <= static_cast<value_type>( 2 * n ) ; ++v )
+            {
+                all_match = all_match && index.lbound( v ) == std::lower_bound( first, last, v )
+                                      && index.ubound( v ) == std::upper_bound( first, last, v )
+                                      && index.bsearch( v ) == ( v % 2 == 0 && v < static_cast<value_type>( 2 * n ) ? first + v / 2 : last );
+            }
+        }
+        EXPECT_TRUE( all_match );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm16, "Duplicates", "Repeated keys, including the padding key itself, are handled like sa::lbound." );
+        // DISABLE();
+        const value_type max = std::numeric_limits<value_type>::max();
+        value_type A[]{ -5, -5, 0, 0, 0, 3, 8, 8, max, max };
+        auto first = std::begin(A), last = std::end(A);
+        veb_index index{ first, last };
+
+        for ( value_type v : { -6, -5, -1, 0, 2, 3, 8, 9, max - 1, max } )
+        {
+            EXPECT_EQ( index.lbound( v ), lbound( first, last, v ) );
+            EXPECT_EQ( index.ubound( v ), ubound( first, last, v ) );
+            EXPECT_EQ( index.bsearch( v ), ( std::binary_search( first, last, v ) ? std::lower_bound( first, last, v ) : last ) );
+        }
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm16, "Large", "Random queries on a large array match sa::lbound." );
+        // DISABLE();
+        std::mt19937 rng{ 21 };
+        std::uniform_int_distribution<value_type> key( 0, 1 << 22 );
+        std::vector<value_type> A( 1000003 );
+        for ( auto & a : A ) a = key( rng );
+        std::sort( A.begin(), A.end() );
+        auto first = A.data(), last = A.data() + A.size();
+        veb_index index{ first, last };
+
+        EXPECT_EQ( index.height(), 20 );
+        bool all_match{true};
+        for ( int q{0} ; q < 100000 ; ++q )
+        {
+            value_type v = key( rng );
+            all_match = all_match && index.lbound( v ) == lbound( first, last, v );
+        }
+        EXPECT_TRUE( all_match );
+    }
+
+    tm16.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the build stage.
+    TestManager tm17{ "Sorting Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm17, "RadixSort", "The radix sort agrees with std::sort, sequential and parallel." );
+        // DISABLE();
+        std::mt19937 rng{ 3 };
+        bool all_match{true};
+        for ( size_t n : { 0, 1, 63, 64, 1000, 70000, 1 << 20 } )
+        {
+            for ( unsigned threads : { 1u, 4u } )
+            {
+                for ( value_type range : { 100, std::numeric_limits<value_type>::max() } )
+                {
+                    std::uniform_int_distribution<value_type> key( -range, range );
+                    std::vector<value_type> A( n );
+                    for ( auto & a : A ) a = key( rng );
+                    if ( n > 2 ) { A[0] = std::numeric_limits<value_type>::min(); A[1] = std::numeric_limits<value_type>::max(); }
+                    std::vector<value_type> expected( A );
+                    std::sort( expected.begin(), expected.end() );
+
+                    radix_sort( A.data(), A.data() + A.size(), threads );
+                    all_match = all_match && A == expected;
+                }
+            }
+        }
+        EXPECT_TRUE( all_match );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm17, "Dedup", "Dedup keeps one copy of every value, like std::unique." );
+        // DISABLE();
+        value_type A[]{ -3, -3, 0, 1, 1, 1, 2, 5, 5 };
+        std::vector<value_type> B( std::begin(A), std::end(A) );
+        value_type * last = dedup( std::begin(A), std::end(A) );
+        B.erase( std::unique( B.begin(), B.end() ), B.end() );
+
+        EXPECT_EQ( static_cast<size_t>( last - std::begin(A) ), B.size() );
+        EXPECT_TRUE( std::equal( B.begin(), B.end(), std::begin(A) ) );
+        EXPECT_EQ( dedup( std::begin(A), std::begin(A) ), std::begin(A) );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm17, "IsSorted", "Inversions are found wherever they are, including across thread chunks." );
+        // DISABLE();
+        std::vector<value_type> A( 1 << 20 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i / 3 );
+        auto first = A.data(), last = A.data() + A.size();
+
+        EXPECT_TRUE( is_sorted( first, last, 1 ) );
+        EXPECT_TRUE( is_sorted( first, last, 4 ) );
+        EXPECT_TRUE( is_sorted( first, first ) );
+        bool all_found{true};
+        for ( size_t at : { size_t{1}, size_t{7}, A.size() / 4, A.size() / 4 + 1, A.size() / 2, A.size() - 1 } )
+        {
+            value_type saved = A[at];
+            A[at] = A[at - 1] - 1;
+            all_found = all_found && not is_sorted( first, last, 1 ) && not is_sorted( first, last, 4 );
+            A[at] = saved;
+        }
+        EXPECT_TRUE( all_found );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm17, "RequireSorted", "require_sorted() throws on unsorted input only." );
+        // DISABLE();
+        value_type A[]{ 1, 2, 3, 2 };
+        bool thrown{false};
+        try { require_sorted( std::begin(A), std::end(A) ); }
+        catch ( const std::invalid_argument & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        thrown = false;
+        try { require_sorted( std::begin(A), std::begin(A) + 3 ); }
+        catch ( const std::invalid_argument & ) { thrown = true; }
+        EXPECT_FALSE( thrown );
+    }
+
+    tm17.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for fractional cascading.
+    TestManager tm18{ "Fractional Cascading Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm18, "MatchesLbound", "Every per-array position matches std::lower_bound, with empty and repeated arrays." );
+        // DISABLE();
+        std::mt19937 rng{ 8 };
+        std::uniform_int_distribution<value_type> key( -300, 300 );
+        std::vector< std::vector<value_type> > shards;
+        for ( size_t n : { 50, 0, 1, 400, 7, 0, 1000, 33, 2, 250 } )
+        {
+            std::vector<value_type> S( n );
+            for ( auto & s : S ) s = key( rng );
+            std::sort( S.begin(), S.end() );
+            shards.push_back( S );
+        }
+        std::vector< std::pair<value_type *, value_type *> > ranges;
+        for ( auto & S : shards ) ranges.push_back( std::make_pair( S.data(), S.data() + S.size() ) );
+        cascade_index index{ ranges };
+
+        EXPECT_EQ( index.n_arrays(), shards.size() );
+        bool all_match{true};
+        for ( value_type v{-310} ; v <= 310 ; ++v )
+        {
+            std::vector<size_t> positions = index.lbound( v );
+            for ( size_t i{0} ; i < shards.size() ; ++i )
+            {
+                size_t expected = static_cast<size_t>( std::lower_bound( shards[i].begin(), shards[i].end(), v ) - shards[i].begin() );
+                all_match = all_match && positions[i] == expected;
+            }
+        }
+        EXPECT_TRUE( all_match );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm18, "Extremes", "Keys at the limits of value_type and an index with no arrays." );
+        // DISABLE();
+        const value_type min = std::numeric_limits<value_type>::min(), max = std::numeric_limits<value_type>::max();
+        value_type A[]{ min, min, 0, max };
+        value_type B[]{ min, max, max };
+        cascade_index index{ { std::make_pair( std::begin(A), std::end(A) ), std::make_pair( std::begin(B), std::end(B) ) } };
+
+        EXPECT_TRUE( ( index.lbound( min ) == ( std::vector<size_t>{ 0, 0 } ) ) );
+        EXPECT_TRUE( ( index.lbound( 0 ) == ( std::vector<size_t>{ 2, 1 } ) ) );
+        EXPECT_TRUE( ( index.lbound( max ) == ( std::vector<size_t>{ 3, 1 } ) ) );
+        EXPECT_TRUE( cascade_index{ {} }.lbound( 0 ).empty() );
+    }
+
+    tm18.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the latency histograms.
+    TestManager tm19{ "Latency Histogram Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm19, "Buckets", "Every value falls in a bucket that holds it, within about 3% of its upper end." );
+        // DISABLE();
+        bool all_fit{true};
+        for ( std::uint64_t v : { 0ull, 1ull, 31ull, 32ull, 33ull, 63ull, 64ull, 1000ull, 123456789ull, ( 1ull << 40 ) - 1 } )
+        {
+            size_t b = latency_histogram::bucket_of( v );
+            all_fit = all_fit && latency_histogram::highest_in( b ) >= v
+                              && ( b == 0 || latency_histogram::highest_in( b - 1 ) < v )
+                              && latency_histogram::highest_in( b ) - v <= v / 32;
+        }
+        EXPECT_TRUE( all_fit );
+        EXPECT_EQ( latency_histogram::bucket_of( std::numeric_limits<std::uint64_t>::max() ), latency_histogram::n_buckets - 1 );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm19, "Percentiles", "Percentiles of 1..1000 are found to within a bucket, and histograms merge." );
+        // DISABLE();
+        latency_histogram h, g;
+        for ( std::uint64_t v{1} ; v <= 1000 ; ++v ) ( v % 2 ? h : g ).record( v );
+        h.merge( g );
+
+        EXPECT_EQ( h.count(), 1000u );
+        EXPECT_TRUE( ( h.percentile( 50 ) >= 500 && h.percentile( 50 ) <= 500 + 500 / 32 ) );
+        EXPECT_TRUE( ( h.percentile( 99 ) >= 990 && h.percentile( 99 ) <= 990 + 990 / 32 ) );
+        EXPECT_TRUE( ( h.max() >= 1000 && h.max() <= 1000 + 1000 / 32 ) );
+        EXPECT_EQ( h.percentile( 0 ), 1u );
+        h.clear();
+        EXPECT_EQ( h.percentile( 50 ), 0u );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm19, "Sampling", "Instrumented calls return the plain results, and one call in N is recorded." );
+        // DISABLE();
+        std::vector<value_type> A( 4096 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( 2 * i );
+        auto first = A.data(), last = A.data() + A.size();
+
+        reset_latency();
+        set_latency_sample_period( 4 );
+        bool all_match{true};
+        for ( value_type v{0} ; v < 4000 ; ++v )
+        {
+            all_match = all_match && instrumented::lbound( first, last, v ) == lbound( first, last, v )
+                                  && instrumented::bsearch( first, last, v ) == bsearch( first, last, v );
+        }
+        EXPECT_TRUE( all_match );
+        // 8000 calls: the two algorithms share the countdown, 2000 samples in all.
+        EXPECT_EQ( latency_snapshot( algorithm_t::LBOUND ).count() + latency_snapshot( algorithm_t::BSEARCH ).count(), 2000u );
+        EXPECT_EQ( latency_snapshot( algorithm_t::UBOUND ).count(), 0u );
+
+        set_latency_sample_period( 0 );
+        for ( value_type v{0} ; v < 4000 ; ++v ) instrumented::ubound( first, last, v );
+        EXPECT_TRUE( ( latency_snapshot( algorithm_t::UBOUND ).count() <= 4u ) );
+        set_latency_sample_period( 64 );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm19, "Threads", "Samples from several threads are merged, and reported as text and JSON." );
+        // DISABLE();
+        std::vector<value_type> A( 1000 );
+        for ( size_t i{0} ; i < A.size() ; ++i ) A[i] = static_cast<value_type>( i );
+        auto first = A.data(), last = A.data() + A.size();
+
+        reset_latency();
+        set_latency_sample_period( 1 );
+        std::vector<std::thread> workers;
+        for ( int t{0} ; t < 4 ; ++t )
+        {
+            workers.push_back( std::thread( [=]() {
+                for ( value_type v{0} ; v < 1000 ; ++v ) instrumented::exp_lbound( first, last, v );
+            } ) );
+        }
+        for ( auto & w : workers ) w.join();
+        set_latency_sample_period( 64 );
+
+        EXPECT_EQ( latency_snapshot( algorithm_t::EXP_LBOUND ).count(), 4000u );
+        std::string text = latency_report_text(), json = latency_report_json();
+        EXPECT_NE( text.find( "exp_lbound" ), std::string::npos );
+        EXPECT_NE( json.find( "\"exp_lbound\":{\"samples\":4000" ), std::string::npos );
+        EXPECT_NE( json.find( "\"p99.9_ns\"" ), std::string::npos );
+        EXPECT_EQ( json.find( "\"lbound\"" ), std::string::npos );
+    }
+
+    tm19.summary();
+    std::cout << std::endl;
+
+    // Creates a test manager for the segmented searches.
+    TestManager tm20{ "Segmented Search Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm20, "MatchesSTL", "Every segment, short or long, gets the same answers as the STL." );
+        // DISABLE();
+        std::mt19937 rng{ 13 };
+        std::uniform_int_distribution<size_t> length( 0, 200 );
+        std::uniform_int_distribution<value_type> key( -100, 100 );
+        std::vector<value_type> values;
+        std::vector<size_t> offsets{ 0 };
+        std::vector<value_type> queries;
+        for ( int s{0} ; s < 3000 ; ++s )
+        {
+            size_t n = s % 3 == 0 ? length( rng ) : length( rng ) % 65;
+            std::vector<value_type> segment( n );
+            for ( auto & v : segment ) v = key( rng );
+            std::sort( segment.begin(), segment.end() );
+            values.insert( values.end(), segment.begin(), segment.end() );
+            offsets.push_back( values.size() );
+            queries.push_back( key( rng ) + ( s % 7 == 0 ? 150 : 0 ) );
+        }
+        const size_t n_segments = queries.size();
+        std::vector<size_t> lb( n_segments ), ub( n_segments ), bs( n_segments );
+        segmented_lbound( values.data(), offsets.data(), n_segments, queries.data(), lb.data() );
+        segmented_ubound( values.data(), offsets.data(), n_segments, queries.data(), ub.data() );
+        segmented_bsearch( values.data(), offsets.data(), n_segments, queries.data(), bs.data() );
+
+        bool all_match{true};
+        for ( size_t s{0} ; s < n_segments ; ++s )
+        {
+            auto first = values.begin() + static_cast<std::ptrdiff_t>( offsets[s] );
+            auto last = values.begin() + static_cast<std::ptrdiff_t>( offsets[s + 1] );
+            size_t n = offsets[s + 1] - offsets[s];
+            size_t l = static_cast<size_t>( std::lower_bound( first, last, queries[s] ) - first );
+            all_match = all_match && lb[s] == l
+                                  && ub[s] == static_cast<size_t>( std::upper_bound( first, last, queries[s] ) - first )
+                                  && bs[s] == ( l < n && first[l] == queries[s] ? l : n );
+        }
+        EXPECT_TRUE( all_match );
+    }
+
+    {
+        //=== Test #2
+        BEGIN_TEST(tm20, "Extremes", "Keys and queries at the limits of value_type." );
+        // DISABLE();
+        const value_type min = std::numeric_limits<value_type>::min(), max = std::numeric_limits<value_type>::max();
+        value_type values[]{ min, min, 0, max, max, max, min, max };
+        size_t offsets[]{ 0, 6, 8, 8 };
+        value_type queries[]{ max, min, 5 };
+        size_t out[3];
+
+        segmented_lbound( values, offsets, 3, queries, out );
+        EXPECT_EQ( out[0], 3u );
+        EXPECT_EQ( out[1], 0u );
+        EXPECT_EQ( out[2], 0u );
+        segmented_ubound( values, offsets, 3, queries, out );
+        EXPECT_EQ( out[0], 6u );
+        EXPECT_EQ( out[1], 1u );
+    }
+
+    tm20.summary();
+    std::cout << std::endl;
+
+    TestManager tm21{ "Cracking Index Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm21, "MatchesSTL", "Lookups and range queries on an unsorted array agree with counting." );
+        // DISABLE();
+        std::mt19937 rng{ 21 };
+        std::uniform_int_distribution<value_type> key( -500, 500 );
+        std::vector<value_type> data( 5000 );
+        for ( auto & v : data ) v = key( rng );
+        std::vector<value_type> original( data );
+        std::sort( original.begin(), original.end() );
+
+        cracking_index index( data.data(), data.data() + data.size() );
+        value_type * last = data.data() + data.size();
+        bool all_match{true};
+        for ( int q{0} ; q < 2000 ; ++q )
+        {
+            value_type value = key( rng ) + ( q % 11 == 0 ? 600 : 0 );
+            size_t expected = static_cast<size_t>( std::count( original.begin(), original.end(), value ) );
+            value_type * found = index.find( value );
+            all_match = all_match && ( expected == 0 ? found == last : *found == value )
+                                  && index.count( value ) == expected;
+
+            value_type low = key( rng ), high = low + key( rng ) % 50;
+            auto r = index.range( low, high );
+            size_t in_range = static_cast<size_t>( std::count_if( original.begin(), original.end(),
+                        [low, high]( value_type x ) { return low <= x && x < high; } ) );
+            all_match = all_match && static_cast<size_t>( r.second - r.first ) == in_range
+                                  && std::all_of( r.first, r.second, [low, high]( value_type x ) { return low <= x && x < high; } );
+        }
+        EXPECT_TRUE( all_match );
+        EXPECT_TRUE( ( index.n_pieces() > 1 ) );
+        std::sort( data.begin(), data.end() );
+        EXPECT_TRUE( ( data == original ) );
+    }
+    {
+        //=== Test #2
+        BEGIN_TEST(tm21, "Boundaries", "Partition points hold for every key seen, and at the limits of value_type." );
+        // DISABLE();
+        const value_type lo{ std::numeric_limits<value_type>::min() }, hi{ std::numeric_limits<value_type>::max() };
+        std::vector<value_type> data{ 5, hi, 3, lo, 9, 3, hi, 0, -7, lo };
+        value_type * first = data.data();
+        value_type * last = first + data.size();
+        cracking_index index( first, last );
+        EXPECT_EQ( index.size(), data.size() );
+        EXPECT_EQ( index.count( hi ), 2u );
+        EXPECT_EQ( index.count( lo ), 2u );
+        EXPECT_EQ( index.count( 3 ), 2u );
+        EXPECT_EQ( index.count( 4 ), 0u );
+        EXPECT_EQ( index.find( 4 ), last );
+        EXPECT_EQ( index.partition_point( lo ), first );
+
+        bool partitioned{true};
+        for ( value_type value : { lo, -7, 0, 3, 4, 5, 9, hi } )
+        {
+            value_type * p = index.partition_point( value );
+            partitioned = partitioned && std::all_of( first, p, [value]( value_type x ) { return x < value; } )
+                                      && std::none_of( p, last, [value]( value_type x ) { return x < value; } );
+        }
+        EXPECT_TRUE( partitioned );
+        auto r = index.range( 9, 3 );
+        EXPECT_EQ( r.first, r.second );
+
+        cracking_index empty( first, first );
+        EXPECT_EQ( empty.find( 3 ), first );
+        EXPECT_EQ( empty.count( 3 ), 0u );
+    }
+
+    tm21.summary();
+    std::cout << std::endl;
+
+    TestManager tm22{ "Weighted Index Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm22, "MatchesSTL", "Lookups agree with the STL, before and after rebuilding from sampled counters." );
+        // DISABLE();
+        std::mt19937 rng{ 22 };
+        std::uniform_int_distribution<value_type> key( -3000, 3000 );
+        std::vector<value_type> data( 20000 );
+        for ( auto & v : data ) v = key( rng );
+        std::sort( data.begin(), data.end() );
+        value_type * first = data.data();
+        value_type * last = first + data.size();
+
+        weighted_index index( first, last, nullptr, 64 );
+        index.set_sample_period( 1 );
+        bool all_match{true};
+        for ( int round{0} ; round < 3 ; ++round )
+        {
+            for ( int q{0} ; q < 5000 ; ++q )
+            {
+                value_type value = q % 2 ? key( rng ) / 100 : key( rng ) + ( q % 13 == 0 ? 4000 : 0 );
+                value_type * l = std::lower_bound( first, last, value );
+                all_match = all_match && index.lbound( value ) == l
+                                      && index.bsearch( value ) == ( l != last && *l == value ? l : last );
+            }
+            index.rebuild();
+        }
+        EXPECT_TRUE( all_match );
+        EXPECT_EQ( index.size(), data.size() );
+        EXPECT_EQ( index.tier_size(), 64u );
+
+        weighted_index empty( first, first );
+        EXPECT_EQ( empty.lbound( 3 ), first );
+        EXPECT_EQ( empty.bsearch( 3 ), first );
+    }
+    {
+        //=== Test #2
+        BEGIN_TEST(tm22, "HotKeys", "Heavy keys are placed near the root and lower the expected probe count." );
+        // DISABLE();
+        std::vector<value_type> data( 1 << 16 );
+        for ( size_t i{0} ; i < data.size() ; ++i ) data[i] = static_cast<value_type>( 3 * i );
+        value_type * first = data.data();
+        value_type * last = first + data.size();
+
+        weighted_index uniform( first, last );
+        std::vector<std::uint64_t> weights( data.size(), 0 );
+        weights[ 12345 ] = 1000000;
+        weights[ 60000 ] = 500000;
+        weighted_index skewed( first, last, weights.data() );
+        EXPECT_TRUE( ( skewed.expected_probes() < uniform.expected_probes() / 2 ) );
+        EXPECT_EQ( skewed.bsearch( 3 * 12345 ), first + 12345 );
+        EXPECT_EQ( skewed.bsearch( 3 * 60000 ), first + 60000 );
+        EXPECT_EQ( skewed.bsearch( 1 ), last );
+
+        // The same skew, learnt from the lookups themselves.
+        uniform.set_sample_period( 1 );
+        for ( int q{0} ; q < 1000 ; ++q ) uniform.bsearch( 3 * 12345 );
+        double before = uniform.expected_probes();
+        uniform.rebuild();
+        EXPECT_TRUE( ( uniform.expected_probes() < before / 2 ) );
+
+        // Duplicates: lookups find the first occurrence.
+        std::vector<value_type> dups{ 1, 1, 1, 4, 4, 9, 9, 9, 9 };
+        std::vector<std::uint64_t> dup_weights{ 0, 0, 0, 0, 0, 0, 0, 0, 100 };
+        weighted_index dup_index( dups.data(), dups.data() + dups.size(), dup_weights.data(), 2 );
+        EXPECT_EQ( dup_index.bsearch( 9 ), dups.data() + 5 );
+        EXPECT_EQ( dup_index.bsearch( 4 ), dups.data() + 3 );
+        EXPECT_EQ( dup_index.lbound( 2 ), dups.data() + 3 );
+        EXPECT_EQ( dup_index.lbound( 10 ), dups.data() + dups.size() );
+    }
+
+    {
+        //=== Test #3
+        BEGIN_TEST(tm22, "SamplingPerIndex", "Indexes sample at their own rate, and keep the weights they were built with." );
+        // DISABLE();
+        std::vector<value_type> data( 4096 );
+        for ( size_t i{0} ; i < data.size() ; ++i ) data[i] = static_cast<value_type>( i );
+        value_type * first = data.data();
+        value_type * last = first + data.size();
+
+        // `rare` samples 2 of its 2000 lookups (the first and the 1001st), so it never reaches 3,
+        // however the lookups of `busy` are interleaved with its own.
+        weighted_index rare( first, last ), busy( first, last );
+        rare.set_sample_period( 1000 );
+        rare.set_rebuild_after( 3 );
+        busy.set_sample_period( 1 );
+        const double before = rare.expected_probes();
+        for ( int q{0} ; q < 2000 ; ++q )
+        {
+            rare.bsearch( 7 );
+            busy.bsearch( 4000 );
+        }
+        EXPECT_EQ( rare.expected_probes(), before );
+        rare.bsearch( 7 );  // The 2001st lookup is its third sample, and rebuilds.
+        EXPECT_TRUE( ( rare.expected_probes() < before / 2 ) );
+
+        // Weights given up front survive a rebuild with nothing sampled.
+        std::vector<std::uint64_t> weights( data.size(), 0 );
+        weights[ 100 ] = 100000;
+        weighted_index seeded( first, last, weights.data() );
+        seeded.set_sample_period( 0 );
+        const double built = seeded.expected_probes();
+        seeded.rebuild();
+        EXPECT_TRUE( ( seeded.expected_probes() < weighted_index( first, last ).expected_probes() / 2 ) );
+        EXPECT_TRUE( ( seeded.expected_probes() - built < 0.5 ) );
+    }
+
+    {
+        //=== Test #4
+        BEGIN_TEST(tm22, "CopyOutlivesSource", "Copies and moves keep their own counters, and keep sampling once the source is gone." );
+        // DISABLE();
+        std::vector<value_type> data( 4096 );
+        for ( size_t i{0} ; i < data.size() ; ++i ) data[i] = static_cast<value_type>( i );
+        value_type * first = data.data();
+        value_type * last = first + data.size();
+
+        std::unique_ptr<weighted_index> source( new weighted_index( first, last ) );
+        source->set_sample_period( 1 );
+        for ( int q{0} ; q < 10 ; ++q ) source->bsearch( 7 );
+        weighted_index copy( *source );
+        source.reset();
+
+        const double before = copy.expected_probes();
+        copy.set_rebuild_after( 100 );
+        for ( int q{0} ; q < 90 ; ++q ) copy.bsearch( 7 );  // 100 samples with the 10 copied over.
+        EXPECT_TRUE( ( copy.expected_probes() < before / 2 ) );
+
+        weighted_index moved( std::move( copy ) );
+        EXPECT_EQ( moved.lbound( 4000 ), first + 4000 );
+        weighted_index assigned( first, first );
+        assigned = moved;
+        EXPECT_EQ( assigned.size(), data.size() );
+        EXPECT_EQ( assigned.memory_bytes(), moved.memory_bytes() );
+        EXPECT_EQ( assigned.bsearch( 7 ), first + 7 );
+    }
+
+    tm22.summary();
+    std::cout << std::endl;
+
+    TestManager tm23{ "Set Operations Test Suite" };
+
+    {
+        //=== Test #1
+        BEGIN_TEST(tm23, "MatchesSTL", "Intersections and unions of similar and skewed sizes agree with the STL." );
+        // DISABLE();
+        std::mt19937 rng{ 23 };
+        bool all_match{true};
+        for ( size_t n1 : { 0, 1, 7, 100, 3000 } )
+        {
+            for ( size_t n2 : { 0, 3, 9, 100, 5000, 200000 } )
+            {
+                std::uniform_int_distribution<value_type> key( -static_cast<value_type>( n1 + n2 ), static_cast<value_type>( n1 + n2 ) );
+                std::vector<value_type> a( n1 ), b( n2 );
+                for ( auto & v : a ) v = key( rng );
+                for ( auto & v : b ) v = key( rng );
+                std::sort( a.begin(), a.end() );
+                std::sort( b.begin(), b.end() );
+                a.erase( std::unique( a.begin(), a.end() ), a.end() );
+                b.erase( std::unique( b.begin(), b.end() ), b.end() );
+
+                std::vector<value_type> expected, got( a.size() + b.size() );
+                std::set_intersection( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( expected ) );
+                value_type * end = intersect( a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), got.data() );
+                all_match = all_match && std::equal( expected.begin(), expected.end(), got.data() )
+                                      && static_cast<size_t>( end - got.data() ) == expected.size()
+                                      && intersect_count( b.data(), b.data() + b.size(), a.data(), a.data() + a.size() ) == expected.size();
+
+                expected.clear();
+                std::set_union( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( expected ) );
+                end = set_union( b.data(), b.data() + b.size(), a.data(), a.data() + a.size(), got.data() );
+                all_match = all_match && std::equal( expected.begin(), expected.end(), got.data() )
+                                      && static_cast<size_t>( end - got.data() ) == expected.size();
+            }
+        }
+        EXPECT_TRUE( all_match );
+    }
+    {
+        //=== Test #2
+        BEGIN_TEST(tm23, "KWay", "Many lists intersected at once, and in place." );
+        // DISABLE();
+        std::vector<std::vector<value_type>> lists;
+        for ( value_type step : { 2, 3, 5, 1 } )
+        {
+            std::vector<value_type> list;
+            for ( value_type v{ -1000 } ; v <= 1000 ; v += step ) list.push_back( v );
+            lists.push_back( list );
+        }
+        std::vector<std::pair<const value_type *, const value_type *>> ranges;
+        for ( const auto & list : lists ) ranges.emplace_back( list.data(), list.data() + list.size() );
+
+        std::vector<value_type> out( 2001 );
+        value_type * end = intersect( ranges.data(), ranges.size(), out.data() );
+        std::vector<value_type> expected;
+        for ( value_type v{ -1000 } ; v <= 1000 ; v += 30 ) expected.push_back( v );
+        EXPECT_EQ( static_cast<size_t>( end - out.data() ), expected.size() );
+        EXPECT_TRUE( std::equal( expected.begin(), expected.end(), out.data() ) );
+
+        EXPECT_EQ( intersect( ranges.data(), 0, out.data() ), out.data() );
+        end = intersect( ranges.data() + 3, 1, out.data() );
+        EXPECT_EQ( static_cast<size_t>( end - out.data() ), lists[3].size() );
+
+        // An empty list empties the result.
+        ranges.emplace_back( lists[0].data(), lists[0].data() );
+        EXPECT_EQ( intersect( ranges.data(), ranges.size(), out.data() ), out.data() );
+
+        // In place: the result overwrites the first range.
+        std::vector<value_type> in_place( lists[0] );
+        end = intersect( in_place.data(), in_place.data() + in_place.size(), lists[1].data(), lists[1].data() + lists[1].size(), in_place.data() );
+        bool every_sixth = static_cast<size_t>( end - in_place.data() ) == 334;
+        for ( value_type * p = in_place.data() ; p != end ; ++p ) every_sixth = every_sixth && ( *p + 1000 ) % 6 == 0;
+        EXPECT_TRUE( every_sixth );
+    }
+
+    tm23.summary();
+    std::cout << std::endl;
+
     return EXIT_SUCCESS;
 }
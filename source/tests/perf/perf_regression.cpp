@@ -0,0 +1,398 @@
+/**
+ * @file perf_regression.cpp
+ * @brief Performance regression suite for the algorithms in `searching.h`.
+ *
+ * For fixed seeds and sizes, every algorithm is first checked element-for-element against the
+ * STL (`std::lower_bound`, `std::upper_bound`, `std::find`) on randomized inputs, and then timed.
+ * Timings are compared against a checked-in JSON baseline with a one-sided Mann-Whitney U test:
+ * a kernel regresses when its median slows down by more than `--threshold` _and_ the test says
+ * the slowdown is not noise (p < `--alpha`). All timings are taken relative to `std::lower_bound`
+ * measured in the same round, so the comparison is not thrown off by the machine as a whole
+ * running faster or slower than when the baseline was recorded.
+ *
+ * Usage: perf_regression [--baseline file.json] [--update] [--threshold 0.10] [--alpha 0.01]
+ *
+ * The exit code is non-zero on any mismatch or regression. Baselines are only meaningful on the
+ * machine and build they were recorded with: dividing by `std::lower_bound` cancels the speed of
+ * the machine, not that of the build, since inlined STL code gains more from optimization than
+ * the `sa` kernels do. The baseline therefore records the build type and compiler flags, and the
+ * timings are not compared (the exit code is non-zero) when this build differs; re-record it
+ * with `--update`. The checked-in baseline comes from a `-DCMAKE_BUILD_TYPE=Release` build.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../src/searching.h"
+using namespace sa;
+
+#ifndef SA_PERF_BASELINE
+#define SA_PERF_BASELINE "baseline.json"
+#endif
+#ifndef SA_PERF_BUILD_TYPE
+#define SA_PERF_BUILD_TYPE ""
+#endif
+#ifndef SA_PERF_CXX_FLAGS
+#define SA_PERF_CXX_FLAGS ""
+#endif
+#ifndef SA_PERF_COMPILER
+#define SA_PERF_COMPILER "unknown"
+#endif
+
+namespace {
+
+    /// What a kernel computes, which decides how its results are checked.
+    enum class kind_t : int { EXACT, LOWER, UPPER };
+
+    /// A kernel under test. Hinted kernels get a random hint; linear kernels get fewer queries.
+    struct kernel_t {
+        const char * name;
+        kind_t kind;
+        bool linear;
+        value_type * (*search)( value_type *, value_type *, value_type );
+        value_type * (*hinted)( value_type *, value_type *, value_type, value_type * );
+    };
+
+    const kernel_t kernels[] = {
+        { "lsearch",     kind_t::EXACT, true,  lsearch,         nullptr },
+        { "bsearch",     kind_t::EXACT, false, bsearch,         nullptr },
+        { "bsearch_rec", kind_t::EXACT, false, bsearch_rec_aux, nullptr },
+        { "lbound",      kind_t::LOWER, false, lbound,          nullptr },
+        { "ubound",      kind_t::UPPER, false, ubound,          nullptr },
+        { "exp_bsearch", kind_t::EXACT, false, exp_bsearch,     nullptr },
+        { "exp_lbound",  kind_t::LOWER, false, exp_lbound,      nullptr },
+        { "exp_ubound",  kind_t::UPPER, false, exp_ubound,      nullptr },
+        { "lbound_hint", kind_t::LOWER, false, nullptr,         lbound_hint },
+        { "ubound_hint", kind_t::UPPER, false, nullptr,         ubound_hint },
+    };
+
+    const std::size_t sizes[] = { 1u << 6, 1u << 12, 1u << 18 };
+    const unsigned seeds[] = { 1, 2, 3 };
+    const int n_samples{ 21 };
+
+    /// Sorted random keys with repetitions, and queries that are half hits, half (mostly) misses.
+    void make_input( std::size_t n, unsigned seed, std::vector<value_type> & data, std::vector<value_type> & queries, std::size_t n_queries )
+    {
+        std::mt19937 rng{ seed };
+        std::uniform_int_distribution<value_type> key( 0, static_cast<value_type>( 2 * n ) );
+        data.resize( n );
+        for ( auto & d : data ) d = key( rng );
+        std::sort( data.begin(), data.end() );
+
+        std::uniform_int_distribution<std::size_t> pick( 0, n - 1 );
+        queries.resize( n_queries );
+        for ( std::size_t q{0} ; q < n_queries ; ++q ) {
+            queries[q] = ( q % 2 == 0 ) ? data[ pick( rng ) ] : key( rng ) - 1;
+        }
+    }
+
+    value_type * run( const kernel_t & k, value_type * first, value_type * last, value_type value, value_type * hint )
+    {
+        return k.hinted ? k.hinted( first, last, value, hint ) : k.search( first, last, value );
+    }
+
+    /// Checks one kernel on one input; returns the number of mismatches.
+    std::size_t check( const kernel_t & k, std::vector<value_type> & data, const std::vector<value_type> & queries, unsigned seed )
+    {
+        value_type* first = data.data();
+        value_type* last = first + data.size();
+        std::mt19937 rng{ seed };
+        std::uniform_int_distribution<std::size_t> pick( 0, data.size() );
+        std::size_t mismatches{0};
+
+        for ( value_type v : queries ) {
+            value_type* result = run( k, first, last, v, first + pick( rng ) );
+            bool ok{false};
+            if ( k.kind == kind_t::LOWER ) {
+                ok = result == std::lower_bound( first, last, v );
+            }
+            else if ( k.kind == kind_t::UPPER ) {
+                ok = result == std::upper_bound( first, last, v );
+            }
+            else {
+                // Any occurrence will do, but hits and misses must agree with the STL. The linear
+                // search is checked against std::find; the others against std::lower_bound.
+                value_type* lb = std::lower_bound( first, last, v );
+                bool present = k.linear ? std::find( first, last, v ) != last : ( lb != last && *lb == v );
+                ok = present ? ( result >= first && result < last && *result == v ) : result == last;
+            }
+            if ( not ok ) {
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    /// The reference every timing is normalized by, so drift in machine speed cancels out.
+    value_type * reference( value_type * first, value_type * last, value_type value )
+    {
+        return std::lower_bound( first, last, value );
+    }
+
+    const kernel_t reference_kernel{ "std::lower_bound", kind_t::LOWER, false, reference, nullptr };
+
+    /// One timing sample: the average ns/query of `k` over `queries`.
+    double time_sample( const kernel_t & k, std::vector<value_type> & data, const std::vector<value_type> & queries )
+    {
+        value_type* first = data.data();
+        value_type* last = first + data.size();
+        value_type* hint = first + data.size() / 2;
+        std::ptrdiff_t sink{0};
+
+        auto start = std::chrono::steady_clock::now();
+        for ( value_type v : queries ) {
+            hint = run( k, first, last, v, hint );
+            sink += hint - first;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        volatile std::ptrdiff_t keep = sink;
+        (void) keep;
+        return std::chrono::duration<double, std::nano>( end - start ).count() / static_cast<double>( queries.size() );
+    }
+
+    double median( std::vector<double> v )
+    {
+        std::sort( v.begin(), v.end() );
+        std::size_t n = v.size();
+        return n == 0 ? 0.0 : ( n % 2 == 1 ? v[n/2] : ( v[n/2 - 1] + v[n/2] ) / 2 );
+    }
+
+    /*!
+     * One-sided Mann-Whitney U test, with tie correction and the normal approximation.
+     * @return The p-value of "`current` tends to be greater than `baseline`".
+     */
+    double mann_whitney_p( const std::vector<double> & baseline, const std::vector<double> & current )
+    {
+        const double n1 = static_cast<double>( baseline.size() );
+        const double n2 = static_cast<double>( current.size() );
+        std::vector< std::pair<double, int> > all;
+        for ( double x : baseline ) all.push_back( std::make_pair( x, 0 ) );
+        for ( double x : current ) all.push_back( std::make_pair( x, 1 ) );
+        std::sort( all.begin(), all.end() );
+
+        // Average ranks over ties.
+        double rank_sum{0}, tie_term{0};
+        for ( std::size_t i{0} ; i < all.size() ; ) {
+            std::size_t j = i;
+            while ( j < all.size() && all[j].first == all[i].first ) ++j;
+            double t = static_cast<double>( j - i );
+            double rank = ( static_cast<double>( i + 1 ) + static_cast<double>( j ) ) / 2;
+            for ( std::size_t r = i ; r < j ; ++r ) {
+                if ( all[r].second == 1 ) rank_sum += rank;
+            }
+            tie_term += t * t * t - t;
+            i = j;
+        }
+
+        const double n = n1 + n2;
+        const double u = rank_sum - n2 * ( n2 + 1 ) / 2;
+        const double mean = n1 * n2 / 2;
+        const double variance = n1 * n2 / 12 * ( ( n + 1 ) - tie_term / ( n * ( n - 1 ) ) );
+        if ( variance <= 0 ) {
+            return 1.0;
+        }
+        const double z = ( u - mean - 0.5 ) / std::sqrt( variance );
+        return 0.5 * std::erfc( z / std::sqrt( 2.0 ) );
+    }
+
+    /// How this binary and `sa` were built, as recorded in a baseline.
+    std::map< std::string, std::string > this_build( void )
+    {
+        std::map< std::string, std::string > build;
+        build["build_type"] = SA_PERF_BUILD_TYPE;
+        build["cxx_flags"] = SA_PERF_CXX_FLAGS;
+        build["compiler"] = SA_PERF_COMPILER;
+        return build;
+    }
+
+    /// Reads `{ "key": "text", ..., "name": [ samples... ], ... }`: text entries describe the build.
+    bool read_baseline( const std::string & path, std::map< std::string, std::vector<double> > & baseline,
+                        std::map< std::string, std::string > & build )
+    {
+        std::ifstream file( path );
+        if ( not file ) {
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        const std::string text = buffer.str();
+
+        std::size_t pos{0};
+        while ( ( pos = text.find( '"', pos ) ) != std::string::npos ) {
+            std::size_t end = text.find( '"', pos + 1 );
+            std::size_t value = end == std::string::npos ? end : text.find_first_not_of( " \t\r\n:", end + 1 );
+            if ( value == std::string::npos ) {
+                break;
+            }
+            std::string name = text.substr( pos + 1, end - pos - 1 );
+            if ( text[value] == '"' ) {
+                std::size_t close = text.find( '"', value + 1 );
+                if ( close == std::string::npos ) {
+                    break;
+                }
+                build[name] = text.substr( value + 1, close - value - 1 );
+                pos = close + 1;
+                continue;
+            }
+            std::size_t close = text.find( ']', value );
+            if ( text[value] != '[' || close == std::string::npos ) {
+                break;
+            }
+            std::string list = text.substr( value + 1, close - value - 1 );
+            std::replace( list.begin(), list.end(), ',', ' ' );
+            std::istringstream values( list );
+            double x;
+            while ( values >> x ) baseline[name].push_back( x );
+            pos = close + 1;
+        }
+        return true;
+    }
+
+    void write_baseline( const std::string & path, const std::map< std::string, std::vector<double> > & results )
+    {
+        std::ofstream file( path );
+        file << "{\n";
+        for ( const auto & b : this_build() ) {
+            file << "  \"" << b.first << "\": \"" << b.second << "\",\n";
+        }
+        std::size_t i{0};
+        for ( const auto & r : results ) {
+            file << "  \"" << r.first << "\": [";
+            for ( std::size_t s{0} ; s < r.second.size() ; ++s ) {
+                file << ( s ? ", " : "" ) << std::fixed << std::setprecision(2) << r.second[s];
+            }
+            file << "]" << ( ++i < results.size() ? "," : "" ) << "\n";
+        }
+        file << "}\n";
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    std::string baseline_path{ SA_PERF_BASELINE };
+    bool update{false};
+    double threshold{0.10}, alpha{0.01};
+    for ( int a{1} ; a < argc ; ++a ) {
+        if ( std::strcmp( argv[a], "--update" ) == 0 ) update = true;
+        else if ( std::strcmp( argv[a], "--baseline" ) == 0 && a + 1 < argc ) baseline_path = argv[++a];
+        else if ( std::strcmp( argv[a], "--threshold" ) == 0 && a + 1 < argc ) threshold = std::atof( argv[++a] );
+        else if ( std::strcmp( argv[a], "--alpha" ) == 0 && a + 1 < argc ) alpha = std::atof( argv[++a] );
+        else {
+            std::cerr << "usage: " << argv[0] << " [--baseline file.json] [--update] [--threshold 0.10] [--alpha 0.01]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // [1] Differential correctness, every kernel, every size, every seed.
+    std::size_t failures{0};
+    std::vector<value_type> data, queries;
+    for ( const auto & k : kernels ) {
+        for ( std::size_t n : sizes ) {
+            for ( unsigned seed : seeds ) {
+                make_input( n, seed, data, queries, k.linear ? 256 : 4096 );
+                std::size_t mismatches = check( k, data, queries, seed );
+                if ( mismatches != 0 ) {
+                    std::cout << "[ MISMATCH ] " << k.name << " n=" << n << " seed=" << seed << ": " << mismatches << " queries\n";
+                    ++failures;
+                }
+            }
+        }
+    }
+    std::cout << "[==========] correctness: " << ( failures == 0 ? "all kernels agree with the STL" : "FAILED" ) << "\n";
+
+    // [2] Timings against the baseline.
+    std::map< std::string, std::vector<double> > baseline, results;
+    std::map< std::string, std::string > recorded_build;
+    const bool have_baseline = not update && read_baseline( baseline_path, baseline, recorded_build );
+    if ( not update && not have_baseline ) {
+        std::cout << "[  NOTICE  ] no baseline at " << baseline_path << "; run with --update to record one.\n";
+    }
+    if ( have_baseline ) {
+        auto build = this_build();
+        const bool stamped = recorded_build.count( "build_type" ) != 0 && recorded_build.count( "cxx_flags" ) != 0;
+        if ( not stamped || recorded_build["build_type"] != build["build_type"] || recorded_build["cxx_flags"] != build["cxx_flags"] ) {
+            if ( not stamped ) {
+                std::cout << "[ REFUSED  ] the baseline does not say which build it was recorded with; re-record it with --update.\n";
+            }
+            else {
+                std::cout << "[ REFUSED  ] the baseline was recorded with build type \"" << recorded_build["build_type"]
+                          << "\" and flags \"" << recorded_build["cxx_flags"] << "\", this build is \"" << build["build_type"]
+                          << "\" with \"" << build["cxx_flags"] << "\"; timings are not comparable.\n"
+                          << "             Configure the same build (-DCMAKE_BUILD_TYPE=" << recorded_build["build_type"]
+                          << "), or re-record with --update.\n";
+            }
+            std::cout << "[==========] timings not compared, " << failures << " mismatch(es).\n";
+            return EXIT_FAILURE;
+        }
+        if ( recorded_build["compiler"] != build["compiler"] ) {
+            std::cout << "[  NOTICE  ] the baseline was recorded with " << recorded_build["compiler"]
+                      << ", this build uses " << build["compiler"] << "; expect some drift.\n";
+        }
+    }
+
+    // Samples are taken round-robin over the kernels of each size, and every sample is divided by
+    // the reference sample of its round, so a machine slowing down mid-run shifts nothing.
+    std::size_t regressions{0};
+    std::vector<value_type> linear_queries;
+    for ( std::size_t n : sizes ) {
+        make_input( n, seeds[0], data, queries, 4096 );
+        // Linear kernels get fewer queries on large arrays, so each sample stays short.
+        std::vector<value_type> unused;
+        make_input( n, seeds[0], unused, linear_queries, std::max<std::size_t>( 16, ( std::size_t{1} << 20 ) / n ) );
+
+        const std::string ref_name = std::string( reference_kernel.name ) + "/" + std::to_string( n );
+        for ( int s{-1} ; s < n_samples ; ++s ) {  // Round -1 is a warm-up.
+            double ref = time_sample( reference_kernel, data, queries );
+            if ( s >= 0 ) results[ref_name].push_back( ref );
+            for ( const auto & k : kernels ) {
+                double t = time_sample( k, data, k.linear ? linear_queries : queries );
+                if ( s >= 0 ) results[ std::string( k.name ) + "/" + std::to_string( n ) ].push_back( t );
+            }
+        }
+
+        auto base_ref = baseline.find( ref_name );
+        for ( const auto & k : kernels ) {
+            const std::string name = std::string( k.name ) + "/" + std::to_string( n );
+            const double now = median( results[name] );
+            std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << now << " ns/query";
+
+            auto it = baseline.find( name );
+            if ( have_baseline && it != baseline.end() && base_ref != baseline.end()
+                 && it->second.size() == base_ref->second.size() && not it->second.empty() ) {
+                std::vector<double> before( it->second.size() ), after( results[name].size() );
+                for ( std::size_t i{0} ; i < before.size() ; ++i ) before[i] = it->second[i] / base_ref->second[i];
+                for ( std::size_t i{0} ; i < after.size() ; ++i ) after[i] = results[name][i] / results[ref_name][i];
+
+                const double change = median( after ) / median( before ) - 1;
+                const double p = mann_whitney_p( before, after );
+                const bool slower = change > threshold && p < alpha;
+                std::cout << "  baseline " << std::setw(10) << median( it->second ) << "  relative change " << std::showpos
+                          << std::setw(7) << std::setprecision(1) << 100 * change << "%" << std::noshowpos
+                          << "  p=" << std::setprecision(4) << p << ( slower ? "  REGRESSION" : "" );
+                regressions += slower;
+            }
+            std::cout << "\n";
+        }
+    }
+
+    if ( update ) {
+        write_baseline( baseline_path, results );
+        std::cout << "[  UPDATED ] baseline written to " << baseline_path << "\n";
+    }
+    std::cout << "[==========] " << regressions << " regression(s), " << failures << " mismatch(es).\n";
+
+    return ( failures == 0 && regressions == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}